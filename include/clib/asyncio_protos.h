@@ -91,5 +91,74 @@ _ASM _ARGS LONG       WriteAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR bu
 _ASM _ARGS LONG       WriteCharAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) UBYTE ch );
 _ASM _ARGS LONG       WriteLineAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) STRPTR line );
 _ASM _ARGS LONG       SeekAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG position, _REG( d1 ) SeekModes mode);
+_ASM _ARGS LONG       ReadVAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) struct AsyncIOVec *vec, _REG( d0 ) LONG count );
+_ASM _ARGS LONG       WriteVAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) struct AsyncIOVec *vec, _REG( d0 ) LONG count );
+_ASM _ARGS LONG       WriteLinesAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) STRPTR *lines, _REG( a2 ) LONG *lengths, _REG( d0 ) LONG count );
+_ASM _ARGS LONG       VFPrintfAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) STRPTR fmt, _REG( a2 ) APTR args );
+LONG                  FPrintfAsync( AsyncFile *file, STRPTR fmt, ... );
+_ASM _ARGS LONG       ReadLongAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) LONG *value );
+_ASM _ARGS LONG       ReadLongsAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) LONG *array, _REG( d0 ) LONG count );
+_ASM _ARGS LONG       ReadEndianAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG count, _REG( d1 ) ULONG format );
+_ASM _ARGS LONG       WriteEndianAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG count, _REG( d1 ) ULONG format );
+_ASM _ARGS LONG       PeekBitsAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG numBits );
+_ASM _ARGS LONG       ReadBitsAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG numBits );
+_ASM _ARGS LONG       WriteBitsAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) ULONG value, _REG( d1 ) LONG numBits );
+_ASM _ARGS LONG       AlignBitsAsync( _REG( a0 ) AsyncFile *file );
+_ASM _ARGS LONG       ReadVarIntAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) ULONG *value );
+_ASM _ARGS LONG       WriteVarIntAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) ULONG value );
+_ASM _ARGS LONG       CopyAsync( _REG( a0 ) AsyncFile *src, _REG( a1 ) AsyncFile *dst, _REG( d0 ) LONG length );
+_ASM _ARGS LONG       TeeAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) BPTR handle );
+_ASM _ARGS LONG       SetDigestAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) ULONG type );
+_ASM _ARGS LONG       GetDigestAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) ULONG *digest );
+_ASM _ARGS LONG       FindAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR pattern, _REG( d0 ) LONG length, _REG( d1 ) ULONG flags );
+_ASM _ARGS LONG       CountLinesAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG limit, _REG( a1 ) ULONG *lines, _REG( a2 ) ULONG *longest );
+_ASM _ARGS struct AsyncLineIndex *BuildLineIndexAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG every, _REG( a1 ) AsyncFile *indexFile );
+_ASM _ARGS struct AsyncLineIndex *LoadLineIndexAsync( _REG( a0 ) AsyncFile *indexFile );
+_ASM _ARGS LONG       ReadLineAtAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) struct AsyncLineIndex *index, _REG( d0 ) ULONG line, _REG( a2 ) STRPTR buffer, _REG( d1 ) LONG size );
+_ASM _ARGS LONG       ReadInPlaceAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR *buffer, _REG( d0 ) LONG numBytes );
+_ASM _ARGS LONG       WriteInPlaceAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR *buffer, _REG( d0 ) LONG numBytes );
+#ifdef ASIO_NOEXTERNALS
+_ASM _ARGS struct AsyncGroup *CreateAsyncGroup( _REG( a0 ) struct ExecBase *SysBase );
+#else
+_ASM _ARGS struct AsyncGroup *CreateAsyncGroup( VOID );
+#endif
+_ASM _ARGS VOID       DeleteAsyncGroup( _REG( a0 ) struct AsyncGroup *group );
+_ASM _ARGS VOID       AttachAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) struct AsyncGroup *group );
+_ASM _ARGS AsyncFile *WaitAnyAsync( _REG( a0 ) struct AsyncGroup *group );
+_ASM _ARGS AsyncFile *PollAsync( _REG( a0 ) struct AsyncGroup *group );
+_ASM _ARGS LONG       TryReadAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG numBytes );
+_ASM _ARGS LONG       TryWriteAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG numBytes );
+_ASM _ARGS LONG       ReadSomeAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG numBytes, _REG( d1 ) LONG timeout );
+#ifdef ASIO_NOEXTERNALS
+_ASM _ARGS struct AsyncBatch *OpenAsyncBatch( _REG( a0 ) STRPTR *names, _REG( d0 ) LONG count, _REG( d1 ) OpenModes mode, _REG( d2 ) LONG bufferSize, _REG( a1 ) struct ExecBase *SysBase, _REG( a2 ) struct DosLibrary *DOSBase );
+#else
+_ASM _ARGS struct AsyncBatch *OpenAsyncBatch( _REG( a0 ) STRPTR *names, _REG( d0 ) LONG count, _REG( d1 ) OpenModes mode, _REG( d2 ) LONG bufferSize );
+#endif
+_ASM _ARGS LONG       NextAsyncBatch( _REG( a0 ) struct AsyncBatch *batch, _REG( a1 ) AsyncFile **file );
+_ASM _ARGS VOID       EndAsyncBatch( _REG( a0 ) struct AsyncBatch *batch );
+#ifdef ASIO_NOEXTERNALS
+_ASM _ARGS struct AsyncDir *OpenAsyncDir( _REG( a0 ) STRPTR name, _REG( d0 ) LONG type, _REG( d1 ) LONG bufferSize, _REG( a1 ) struct ExecBase *SysBase, _REG( a2 ) struct DosLibrary *DOSBase );
+#else
+_ASM _ARGS struct AsyncDir *OpenAsyncDir( _REG( a0 ) STRPTR name, _REG( d0 ) LONG type, _REG( d1 ) LONG bufferSize );
+#endif
+_ASM _ARGS struct ExAllData *ReadAsyncDir( _REG( a0 ) struct AsyncDir *dir );
+_ASM _ARGS VOID       CloseAsyncDir( _REG( a0 ) struct AsyncDir *dir );
+_ASM _ARGS struct AsyncBatch *OpenAsyncDirBatch( _REG( a0 ) struct AsyncDir *dir, _REG( d0 ) OpenModes mode, _REG( d1 ) LONG bufferSize );
+_ASM _ARGS STRPTR     NameAsyncBatch( _REG( a0 ) struct AsyncBatch *batch );
+#ifdef ASIO_NOEXTERNALS
+_ASM _ARGS struct AsyncScheduler *CreateAsyncScheduler( _REG( d0 ) LONG turn, _REG( a0 ) struct ExecBase *SysBase );
+#else
+_ASM _ARGS struct AsyncScheduler *CreateAsyncScheduler( _REG( d0 ) LONG turn );
+#endif
+_ASM _ARGS VOID       DeleteAsyncScheduler( _REG( a0 ) struct AsyncScheduler *scheduler );
+_ASM _ARGS BOOL       ScheduleAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) struct AsyncScheduler *scheduler );
+_ASM _ARGS VOID       SetPriorityAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG priority, _REG( d1 ) LONG maxRate );
+#ifdef ASIO_NOEXTERNALS
+_ASM _ARGS struct AsyncScan *OpenAsyncScan( _REG( a0 ) STRPTR name, _REG( d0 ) LONG ranges, _REG( d1 ) LONG separator, _REG( d2 ) LONG bufferSize, _REG( a1 ) struct ExecBase *SysBase, _REG( a2 ) struct DosLibrary *DOSBase );
+#else
+_ASM _ARGS struct AsyncScan *OpenAsyncScan( _REG( a0 ) STRPTR name, _REG( d0 ) LONG ranges, _REG( d1 ) LONG separator, _REG( d2 ) LONG bufferSize );
+#endif
+_ASM _ARGS LONG       ReadAsyncScan( _REG( a0 ) struct AsyncScan *scan, _REG( a1 ) APTR buffer, _REG( d0 ) LONG numBytes, _REG( a2 ) LONG *index );
+_ASM _ARGS VOID       CloseAsyncScan( _REG( a0 ) struct AsyncScan *scan );
 
 #endif /* CLIB_LIBRARIES_ASYNCIO_H */
\ No newline at end of file
@@ -21,12 +21,18 @@
 #include <dos/dosextens.h>
 #endif
 
+#ifndef DOS_EXALL_H
+#include <dos/exall.h>
+#endif
+
 
 /*****************************************************************************/
 
 
 /* This structure is public only by necessity, don't muck with it yourself, or
- * you're looking for trouble
+ * you're looking for trouble. The exception is af_Offset and af_BytesLeft,
+ * which will stay where they are, with the same meaning, so that the
+ * ASYNC_GETC() and ASYNC_PUTC() macros below can use them.
  */
 typedef struct AsyncFile
 {
@@ -51,9 +57,60 @@ typedef struct AsyncFile
 	UBYTE			af_SeekPastEOF;
 	ULONG			af_LastRes1;
 	ULONG			af_LastBytesLeft;
+	ULONG			af_BitBuffer;
+	ULONG			af_BitCount;
+	struct AsyncTee		*af_Tees;
+	ULONG			af_DigestType;
+	UBYTE			*af_DigestMark;
+	ULONG			af_Digest[2];
+	struct AsyncPack	*af_Packed;
+	ULONG			af_ModeFlags;
+	struct AsyncGroup	*af_Group;
+	struct AsyncFile	*af_NextInGroup;
+	struct AsyncScheduler	*af_Scheduler;
+	struct AsyncFile	*af_NextScheduled;
+	ULONG			af_Ticket;
+	LONG			af_Priority;
+	LONG			af_MaxRate;
+	struct DateStamp	af_RateBase;
+	LONG			af_RateNext;
 } AsyncFile;
 
 
+/* Opens a list of files ahead of their use, see OpenAsyncBatch(). Private. */
+struct AsyncBatch;
+
+
+/* Reads a directory ahead of its use, see OpenAsyncDir(). Private. */
+struct AsyncDir;
+
+
+/* Reads the ranges of a file side by side, see OpenAsyncScan(). Private. */
+struct AsyncScan;
+
+
+/* Takes turns between the files using a device, see CreateAsyncScheduler().
+ * Private.
+ */
+struct AsyncScheduler;
+
+
+/* A group of files that can be waited for together, see CreateAsyncGroup().
+ * Only ag_SignalMask may be used, e.g. to add it to the mask for Wait().
+ */
+struct AsyncGroup
+{
+	ULONG		ag_SignalMask;
+	AsyncFile	*ag_Files;
+	AsyncFile	*ag_Last;
+	struct Task	*ag_Task;
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*ag_SysBase;
+#endif
+	BYTE		ag_SigBit;
+};
+
+
 /*****************************************************************************/
 
 
@@ -64,6 +121,15 @@ typedef enum OpenModes
 	MODE_APPEND	/* append to end of existing file, or create new     */
 } OpenModes;
 
+/* Flags that can be added to the open mode */
+#define MODEF_COMPRESSED	0x100	/* the file is compressed */
+#define MODEF_DIRECT		0x200	/* keep all transfers block-aligned */
+
+/* Priorities for SetPriorityAsync(); any value in between may be used */
+#define ASYNCPRI_BACKGROUND	( -10 )
+#define ASYNCPRI_NORMAL		0
+#define ASYNCPRI_FOREGROUND	10
+
 
 typedef enum SeekModes
 {
@@ -76,6 +142,106 @@ typedef enum SeekModes
 /*****************************************************************************/
 
 
+/* Returned by TryReadAsync() and ReadSomeAsync() when no data has arrived
+ * yet (as opposed to 0 at the end of the file)
+ */
+#define ASYNC_NOTREADY	( -2 )
+
+
+/* One element of the vector passed to ReadVAsync() and WriteVAsync() */
+struct AsyncIOVec
+{
+	APTR	iov_Base;	/* start of the data */
+	LONG	iov_Len;	/* number of bytes at iov_Base */
+};
+
+
+/* Inline versions of ReadCharAsync() and WriteCharAsync(). They work directly
+ * on the buffer, and only call the library when it is empty (or full). The
+ * results are the same as for the functions. Note that file is evaluated
+ * more than once.
+ */
+#define ASYNC_GETC(file) \
+	( ( (file)->af_BytesLeft > 0 ) ? \
+	  ( (file)->af_BytesLeft--, ( LONG ) *(file)->af_Offset++ ) : \
+	  ReadCharAsync( file ) )
+
+#define ASYNC_PUTC(file,ch) \
+	( ( (file)->af_BytesLeft > 0 ) ? \
+	  ( (file)->af_BytesLeft--, *(file)->af_Offset++ = ( UBYTE ) (ch), 1L ) : \
+	  WriteCharAsync( (file), (ch) ) )
+
+
+/* Element formats for ReadEndianAsync() and WriteEndianAsync(). The low bits
+ * hold the size of an element in bytes.
+ */
+#define AEF_SIZEMASK	0x0f
+#define AEF_LITTLE	0x10	/* elements are little-endian in the file */
+
+#define AEF_BE16	2
+#define AEF_BE32	4
+#define AEF_BE64	8
+#define AEF_LE16	( AEF_LITTLE | 2 )
+#define AEF_LE32	( AEF_LITTLE | 4 )
+#define AEF_LE64	( AEF_LITTLE | 8 )
+
+
+/* Convenience macros for ReadEndianAsync() and WriteEndianAsync(). The
+ * single value versions return 1 on success.
+ */
+#define ReadBE16Async(file,ptr)			ReadEndianAsync((file),(ptr),1,AEF_BE16)
+#define ReadBE32Async(file,ptr)			ReadEndianAsync((file),(ptr),1,AEF_BE32)
+#define ReadBE64Async(file,ptr)			ReadEndianAsync((file),(ptr),1,AEF_BE64)
+#define ReadLE16Async(file,ptr)			ReadEndianAsync((file),(ptr),1,AEF_LE16)
+#define ReadLE32Async(file,ptr)			ReadEndianAsync((file),(ptr),1,AEF_LE32)
+#define ReadLE64Async(file,ptr)			ReadEndianAsync((file),(ptr),1,AEF_LE64)
+#define ReadBE16ArrayAsync(file,array,count)	ReadEndianAsync((file),(array),(count),AEF_BE16)
+#define ReadBE32ArrayAsync(file,array,count)	ReadEndianAsync((file),(array),(count),AEF_BE32)
+#define ReadBE64ArrayAsync(file,array,count)	ReadEndianAsync((file),(array),(count),AEF_BE64)
+#define ReadLE16ArrayAsync(file,array,count)	ReadEndianAsync((file),(array),(count),AEF_LE16)
+#define ReadLE32ArrayAsync(file,array,count)	ReadEndianAsync((file),(array),(count),AEF_LE32)
+#define ReadLE64ArrayAsync(file,array,count)	ReadEndianAsync((file),(array),(count),AEF_LE64)
+
+#define WriteBE16Async(file,ptr)		WriteEndianAsync((file),(ptr),1,AEF_BE16)
+#define WriteBE32Async(file,ptr)		WriteEndianAsync((file),(ptr),1,AEF_BE32)
+#define WriteBE64Async(file,ptr)		WriteEndianAsync((file),(ptr),1,AEF_BE64)
+#define WriteLE16Async(file,ptr)		WriteEndianAsync((file),(ptr),1,AEF_LE16)
+#define WriteLE32Async(file,ptr)		WriteEndianAsync((file),(ptr),1,AEF_LE32)
+#define WriteLE64Async(file,ptr)		WriteEndianAsync((file),(ptr),1,AEF_LE64)
+#define WriteBE16ArrayAsync(file,array,count)	WriteEndianAsync((file),(array),(count),AEF_BE16)
+#define WriteBE32ArrayAsync(file,array,count)	WriteEndianAsync((file),(array),(count),AEF_BE32)
+#define WriteBE64ArrayAsync(file,array,count)	WriteEndianAsync((file),(array),(count),AEF_BE64)
+#define WriteLE16ArrayAsync(file,array,count)	WriteEndianAsync((file),(array),(count),AEF_LE16)
+#define WriteLE32ArrayAsync(file,array,count)	WriteEndianAsync((file),(array),(count),AEF_LE32)
+#define WriteLE64ArrayAsync(file,array,count)	WriteEndianAsync((file),(array),(count),AEF_LE64)
+
+
+/* Digest types for SetDigestAsync() */
+#define DIGEST_NONE	0
+#define DIGEST_CRC32	1	/* CRC-32, as used by zip and PNG */
+#define DIGEST_ADLER32	2	/* Adler-32, as used by zlib      */
+#define DIGEST_FNV64	3	/* 64 bit FNV-1a                  */
+
+
+/* Flags for FindAsync() */
+#define FINDF_NOCASE	0x0001	/* ignore case (ISO-8859-1) */
+
+
+/* Line index made by BuildLineIndexAsync() or LoadLineIndexAsync(). It is
+ * a single block of memory, to be freed with exec.library/FreeVec().
+ */
+struct AsyncLineIndex
+{
+	ULONG	ali_Every;	/* an offset is kept for every this many lines */
+	ULONG	ali_Lines;	/* number of lines in the file                 */
+	ULONG	ali_Count;	/* number of offsets                           */
+	LONG	*ali_Offsets;	/* offset of line n * ali_Every in the file    */
+};
+
+
+/*****************************************************************************/
+
+
 #if defined(__SASC) && defined(ASIO_SHARED_LIB)
 extern long __asiolibversion;  /* Minimum version of asyncio.library */
 #endif
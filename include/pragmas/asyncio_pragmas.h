@@ -15,5 +15,54 @@
 #pragma libcall AsyncIOBase FGetsAsync 5a 09803
 #pragma libcall AsyncIOBase FGetsLenAsync 60 a09804
 #pragma libcall AsyncIOBase PeekAsync 66 09803
+#pragma libcall AsyncIOBase ReadVAsync 6c 09803
+#pragma libcall AsyncIOBase WriteVAsync 72 09803
+#pragma libcall AsyncIOBase WriteLinesAsync 78 0a9804
+#pragma libcall AsyncIOBase VFPrintfAsync 7e a9803
+#pragma libcall AsyncIOBase ReadLongAsync 84 9802
+#pragma libcall AsyncIOBase ReadLongsAsync 8a 09803
+#pragma libcall AsyncIOBase ReadEndianAsync 90 109804
+#pragma libcall AsyncIOBase WriteEndianAsync 96 109804
+#pragma libcall AsyncIOBase PeekBitsAsync 9c 0802
+#pragma libcall AsyncIOBase ReadBitsAsync a2 0802
+#pragma libcall AsyncIOBase WriteBitsAsync a8 10803
+#pragma libcall AsyncIOBase AlignBitsAsync ae 801
+#pragma libcall AsyncIOBase ReadVarIntAsync b4 9802
+#pragma libcall AsyncIOBase WriteVarIntAsync ba 0802
+#pragma libcall AsyncIOBase CopyAsync c0 09803
+#pragma libcall AsyncIOBase TeeAsync c6 9802
+#pragma libcall AsyncIOBase SetDigestAsync cc 0802
+#pragma libcall AsyncIOBase GetDigestAsync d2 9802
+#pragma libcall AsyncIOBase FindAsync d8 109804
+#pragma libcall AsyncIOBase CountLinesAsync de a90804
+#pragma libcall AsyncIOBase BuildLineIndexAsync e4 90803
+#pragma libcall AsyncIOBase LoadLineIndexAsync ea 801
+#pragma libcall AsyncIOBase ReadLineAtAsync f0 1a09805
+#pragma libcall AsyncIOBase ReadInPlaceAsync f6 09803
+#pragma libcall AsyncIOBase WriteInPlaceAsync fc 09803
+#pragma libcall AsyncIOBase CreateAsyncGroup 102 00
+#pragma libcall AsyncIOBase DeleteAsyncGroup 108 801
+#pragma libcall AsyncIOBase AttachAsync 10e 9802
+#pragma libcall AsyncIOBase WaitAnyAsync 114 801
+#pragma libcall AsyncIOBase PollAsync 11a 801
+#pragma libcall AsyncIOBase TryReadAsync 120 09803
+#pragma libcall AsyncIOBase TryWriteAsync 126 09803
+#pragma libcall AsyncIOBase ReadSomeAsync 12c 109804
+#pragma libcall AsyncIOBase OpenAsyncBatch 132 210804
+#pragma libcall AsyncIOBase NextAsyncBatch 138 9802
+#pragma libcall AsyncIOBase EndAsyncBatch 13e 801
+#pragma libcall AsyncIOBase OpenAsyncDir 144 10803
+#pragma libcall AsyncIOBase ReadAsyncDir 14a 801
+#pragma libcall AsyncIOBase CloseAsyncDir 150 801
+#pragma libcall AsyncIOBase OpenAsyncDirBatch 156 10803
+#pragma libcall AsyncIOBase NameAsyncBatch 15c 801
+#pragma libcall AsyncIOBase CreateAsyncScheduler 162 001
+#pragma libcall AsyncIOBase DeleteAsyncScheduler 168 801
+#pragma libcall AsyncIOBase ScheduleAsync 16e 9802
+#pragma libcall AsyncIOBase SetPriorityAsync 174 10803
+#pragma libcall AsyncIOBase OpenAsyncScan 17a 210804
+#pragma libcall AsyncIOBase ReadAsyncScan 180 a09804
+#pragma libcall AsyncIOBase CloseAsyncScan 186 801
+#pragma tagcall AsyncIOBase FPrintfAsync 7e a9803
 
 #endif
\ No newline at end of file
@@ -12,6 +12,12 @@ CloseAsync( _REG( a0 ) AsyncFile *file )
 		struct ExecBase		*SysBase = file->af_SysBase;
 		struct DosLibrary	*DOSBase = file->af_DOSBase;
 #endif
+		/* don't lose any bits from WriteBitsAsync() */
+		if( !file->af_ReadMode && file->af_BitCount )
+		{
+			AlignBitsAsync( file );
+		}
+
 		result = AS_WaitPacket( file );
 
 		if( result >= 0 )
@@ -19,16 +25,59 @@ CloseAsync( _REG( a0 ) AsyncFile *file )
 			if( !file->af_ReadMode )
 			{
 				/* this will flush out any pending data in the write buffer */
-				if( file->af_BufferSize > file->af_BytesLeft )
+				if( file->af_BufferSize - file->af_SeekOffset > file->af_BytesLeft )
 				{
-					result = Write(
-						file->af_File,
-						file->af_Buffers[ file->af_CurrentBuf ],
-						file->af_BufferSize - file->af_BytesLeft );
+					if( file->af_Packed )
+					{
+						result = AS_PackBuffer(
+							file,
+							file->af_Buffers[ file->af_CurrentBuf ] + file->af_SeekOffset,
+							file->af_BufferSize - file->af_SeekOffset - file->af_BytesLeft );
+					}
+					else
+					{
+						result = Write(
+							file->af_File,
+							file->af_Buffers[ file->af_CurrentBuf ] + file->af_SeekOffset,
+							file->af_BufferSize - file->af_SeekOffset - file->af_BytesLeft );
+					}
+
+					if( !AS_WriteTees(
+						file,
+						file->af_Buffers[ file->af_CurrentBuf ] + file->af_SeekOffset,
+						file->af_BufferSize - file->af_SeekOffset - file->af_BytesLeft ) )
+					{
+						result = -1;
+					}
 				}
 			}
 		}
 
+		if( file->af_Group )
+		{
+			AttachAsync( file, NULL );
+		}
+
+		if( file->af_Scheduler )
+		{
+			ScheduleAsync( file, NULL );
+		}
+
+		/* the extra destinations are closed by the caller */
+		while( file->af_Tees )
+		{
+			struct AsyncTee	*tee = file->af_Tees;
+
+			file->af_Tees = tee->at_Next;
+			FreeVec( tee );
+		}
+
+		/* this flushes and closes the packed file, and its handle */
+		if( file->af_Packed && ( AS_ClosePack( file->af_Packed ) < 0 ) )
+		{
+			result = -1;
+		}
+
 		if( file->af_CloseFH )
 		{
 			Close( file->af_File );
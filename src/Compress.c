@@ -0,0 +1,474 @@
+#include "async.h"
+
+
+/* A compressed file is a series of blocks. Each starts with a header of
+ * four 16 bit big-endian words: the magic, the flags, the compressed size
+ * and the original size. A block that wouldn't get any smaller is stored
+ * as it is.
+ */
+#define BLOCK_MAGIC	0x415a	/* "AZ" */
+#define BLOCKF_STORED	0x0001
+
+/* LZ parameters. Matches are found with a hash of the next three bytes,
+ * which holds the last position each hash was seen at.
+ */
+#define MIN_MATCH	4
+#define SKIP_SHIFT	5
+#define HASH(p)		( ( ( ( ULONG ) ( p )[ 0 ] << 4 ) ^ ( ( ULONG ) ( p )[ 1 ] << 2 ) ^ ( p )[ 2 ] ) & ( PACK_HASHSIZE - 1 ) )
+
+
+/* Compress length bytes from in to out. A block is a series of sequences,
+ * each made up of a token byte, some literal bytes, and a match. The high
+ * nibble of the token holds the number of literals, the low one the length
+ * of the match, less MIN_MATCH. A nibble of 15 means that more bytes of
+ * length follow, up to and including the first one that isn't 255. The
+ * match is given as a 16 bit offset back from the current position, and
+ * the last sequence has no match.
+ *
+ * Returns the compressed size, or 0 if it would be limit bytes or more.
+ */
+static LONG
+Compress( UWORD *hash, UBYTE *in, LONG length, UBYTE *out, LONG limit )
+{
+	UBYTE	*ip = in;
+	UBYTE	*anchor = in;
+	UBYTE	*end = in + length;
+	UBYTE	*op = out;
+	UBYTE	*opEnd = out + limit;
+	UBYTE	*ref;
+	LONG	literals, matchLength, n;
+	LONG	misses = 0;
+	ULONG	h;
+
+	/* The hash table isn't cleared between blocks. Old entries may point
+	 * anywhere, but are only used when they point to the same bytes
+	 * earlier in this block.
+	 */
+	while( ip + MIN_MATCH <= end )
+	{
+		h		= HASH( ip );
+		ref		= in + hash[ h ];
+		hash[ h ]	= ( UWORD ) ( ip - in );
+
+		if( ( ref >= ip ) || ( ref[ 0 ] != ip[ 0 ] ) || ( ref[ 1 ] != ip[ 1 ] ) ||
+			( ref[ 2 ] != ip[ 2 ] ) || ( ref[ 3 ] != ip[ 3 ] ) )
+		{
+			/* The longer it has been since the last match, the bigger
+			 * the steps. Data that doesn't compress is then skimmed
+			 * rather than searched, and is soon stored as it is.
+			 */
+			ip += 1 + ( misses++ >> SKIP_SHIFT );
+			continue;
+		}
+
+		misses = 0;
+
+		matchLength = MIN_MATCH;
+
+		while( ( ip + matchLength < end ) && ( ref[ matchLength ] == ip[ matchLength ] ) )
+		{
+			++matchLength;
+		}
+
+		literals = ip - anchor;
+
+		/* token, offset, and the worst case for the length bytes */
+		if( op + literals + literals / 255 + matchLength / 255 + 5 > opEnd )
+		{
+			return( 0 );
+		}
+
+		*op++ = ( UBYTE ) ( ( MIN( literals, 15 ) << 4 ) | MIN( matchLength - MIN_MATCH, 15 ) );
+
+		if( literals >= 15 )
+		{
+			for( n = literals - 15; n >= 255; n -= 255 )
+			{
+				*op++ = 255;
+			}
+
+			*op++ = ( UBYTE ) n;
+		}
+
+		while( anchor < ip )
+		{
+			*op++ = *anchor++;
+		}
+
+		*op++ = ( UBYTE ) ( ( ip - ref ) >> 8 );
+		*op++ = ( UBYTE ) ( ip - ref );
+
+		if( matchLength - MIN_MATCH >= 15 )
+		{
+			for( n = matchLength - MIN_MATCH - 15; n >= 255; n -= 255 )
+			{
+				*op++ = 255;
+			}
+
+			*op++ = ( UBYTE ) n;
+		}
+
+		ip	+= matchLength;
+		anchor	= ip;
+	}
+
+	/* the rest goes out as literals */
+	literals = end - anchor;
+
+	if( op + literals + literals / 255 + 2 >= opEnd )
+	{
+		return( 0 );
+	}
+
+	*op++ = ( UBYTE ) ( MIN( literals, 15 ) << 4 );
+
+	if( literals >= 15 )
+	{
+		for( n = literals - 15; n >= 255; n -= 255 )
+		{
+			*op++ = 255;
+		}
+
+		*op++ = ( UBYTE ) n;
+	}
+
+	while( anchor < end )
+	{
+		*op++ = *anchor++;
+	}
+
+	return( op - out );
+}
+
+
+/* Undo Compress(). Returns the size of the data, or -1 if the compressed
+ * data doesn't make sense.
+ */
+static LONG
+Decompress( UBYTE *in, LONG length, UBYTE *out, LONG limit )
+{
+	UBYTE	*ip = in;
+	UBYTE	*ipEnd = in + length;
+	UBYTE	*op = out;
+	UBYTE	*opEnd = out + limit;
+	UBYTE	*ref;
+	LONG	n, offset;
+	UBYTE	token, b;
+
+	for( ;; )
+	{
+		if( ip >= ipEnd )
+		{
+			return( -1 );
+		}
+
+		token	= *ip++;
+		n	= token >> 4;
+
+		if( n == 15 )
+		{
+			do
+			{
+				if( ip >= ipEnd )
+				{
+					return( -1 );
+				}
+
+				b = *ip++;
+				n += b;
+			}
+			while( b == 255 );
+		}
+
+		if( ( n > ipEnd - ip ) || ( n > opEnd - op ) )
+		{
+			return( -1 );
+		}
+
+		while( n-- )
+		{
+			*op++ = *ip++;
+		}
+
+		if( ip == ipEnd )
+		{
+			/* the last sequence has no match */
+			break;
+		}
+
+		if( ipEnd - ip < 2 )
+		{
+			return( -1 );
+		}
+
+		offset	= ( ( LONG ) ip[ 0 ] << 8 ) | ip[ 1 ];
+		ip	+= 2;
+		n	= token & 15;
+
+		if( n == 15 )
+		{
+			do
+			{
+				if( ip >= ipEnd )
+				{
+					return( -1 );
+				}
+
+				b = *ip++;
+				n += b;
+			}
+			while( b == 255 );
+		}
+
+		n += MIN_MATCH;
+
+		if( !offset || ( offset > op - out ) || ( n > opEnd - op ) )
+		{
+			return( -1 );
+		}
+
+		/* the match may overlap the bytes being written, so this has
+		 * to go a byte at a time
+		 */
+		ref = op - offset;
+
+		while( n-- )
+		{
+			*op++ = *ref++;
+		}
+	}
+
+	return( op - out );
+}
+
+
+static VOID
+PutWord( UBYTE *p, ULONG value )
+{
+	p[ 0 ] = ( UBYTE ) ( value >> 8 );
+	p[ 1 ] = ( UBYTE ) value;
+}
+
+
+static ULONG
+GetWord( UBYTE *p )
+{
+	return( ( ( ULONG ) p[ 0 ] << 8 ) | p[ 1 ] );
+}
+
+
+/* compress a buffer and write it to the packed file, in blocks */
+LONG
+AS_PackBuffer( AsyncFile *file, UBYTE *buffer, LONG length )
+{
+	struct AsyncPack	*pack = file->af_Packed;
+	UBYTE			*header = pack->ap_Buffer;
+	LONG			blockLength, packed, left;
+
+	for( left = length; left > 0; left -= blockLength, buffer += blockLength )
+	{
+		blockLength = MIN( left, PACK_BLOCKSIZE );
+
+		PutWord( header, BLOCK_MAGIC );
+		PutWord( header + 6, blockLength );
+
+		if( packed = Compress( pack->ap_Hash, buffer, blockLength, header + PACK_HEADERSIZE, blockLength ) )
+		{
+			PutWord( header + 2, 0 );
+			PutWord( header + 4, packed );
+
+			if( WriteAsync( pack->ap_File, header, PACK_HEADERSIZE + packed ) < 0 )
+			{
+				return( -1 );
+			}
+		}
+		else
+		{
+			PutWord( header + 2, BLOCKF_STORED );
+			PutWord( header + 4, blockLength );
+
+			if( ( WriteAsync( pack->ap_File, header, PACK_HEADERSIZE ) < 0 ) ||
+				( WriteAsync( pack->ap_File, buffer, blockLength ) < 0 ) )
+			{
+				return( -1 );
+			}
+		}
+	}
+
+	return( length );
+}
+
+
+/* read blocks from the packed file and decompress them into the buffer,
+ * for as long as another block is sure to fit
+ */
+static LONG
+UnpackBuffer( AsyncFile *file, UBYTE *buffer )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+	struct AsyncPack	*pack = file->af_Packed;
+	AsyncFile		*packFile = pack->ap_File;
+	UBYTE			header[ PACK_HEADERSIZE ];
+	UBYTE			*data;
+	LONG			total = 0;
+	LONG			result;
+	ULONG			flags, packed, unpacked;
+
+	while( file->af_BufferSize - total >= PACK_BLOCKSIZE )
+	{
+		if( ( result = ReadAsync( packFile, header, PACK_HEADERSIZE ) ) <= 0 )
+		{
+			if( !result )
+			{
+				/* end of file */
+				break;
+			}
+
+			return( -1 );
+		}
+
+		flags		= GetWord( header + 2 );
+		packed		= GetWord( header + 4 );
+		unpacked	= GetWord( header + 6 );
+
+		if( ( result != PACK_HEADERSIZE ) || ( GetWord( header ) != BLOCK_MAGIC ) ||
+			( packed > PACK_BLOCKSIZE ) || ( unpacked > PACK_BLOCKSIZE ) ||
+			( ( flags & BLOCKF_STORED ) && ( packed != unpacked ) ) )
+		{
+			SetIoErr( ERROR_OBJECT_WRONG_TYPE );
+			return( -1 );
+		}
+
+		if( flags & BLOCKF_STORED )
+		{
+			if( ( result = ReadAsync( packFile, buffer + total, packed ) ) != packed )
+			{
+				if( result >= 0 )
+				{
+					SetIoErr( ERROR_OBJECT_WRONG_TYPE );
+				}
+
+				return( -1 );
+			}
+		}
+		else
+		{
+			/* decompress straight from the packed file's buffer, unless
+			 * the block continues in the next one
+			 */
+			if( packFile->af_BytesLeft >= packed )
+			{
+				data				= packFile->af_Offset;
+				packFile->af_Offset		+= packed;
+				packFile->af_BytesLeft		-= packed;
+			}
+			else
+			{
+				data = pack->ap_Buffer;
+
+				if( ( result = ReadAsync( packFile, data, packed ) ) != packed )
+				{
+					if( result >= 0 )
+					{
+						SetIoErr( ERROR_OBJECT_WRONG_TYPE );
+					}
+
+					return( -1 );
+				}
+			}
+
+			if( Decompress( data, packed, buffer + total, unpacked ) != unpacked )
+			{
+				SetIoErr( ERROR_OBJECT_WRONG_TYPE );
+				return( -1 );
+			}
+		}
+
+		total += unpacked;
+	}
+
+	return( total );
+}
+
+
+/* Stands in for sending a packet to the file system, for compressed files.
+ * The data is compressed or decompressed right away, while the packed file
+ * is busy with its own packets. The packet is left as if it had already
+ * come back.
+ */
+VOID
+AS_PackPacket( AsyncFile *file, APTR arg2 )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+	LONG	result;
+
+	if( file->af_ReadMode )
+	{
+		result = UnpackBuffer( file, arg2 );
+	}
+	else
+	{
+		result = AS_PackBuffer( file, arg2, file->af_Packet.sp_Pkt.dp_Arg3 );
+	}
+
+	file->af_Packet.sp_Pkt.dp_Res1	= result;
+	file->af_Packet.sp_Pkt.dp_Res2	= ( result < 0 ) ? IoErr() : 0;
+	file->af_PacketPending		= FALSE;
+}
+
+
+#ifdef ASIO_NOEXTERNALS
+struct AsyncPack *
+AS_OpenPack( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt, struct ExecBase *SysBase, struct DosLibrary *DOSBase )
+#else
+struct AsyncPack *
+AS_OpenPack( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt )
+#endif
+{
+	struct AsyncPack	*pack;
+
+	if( !( pack = AllocVec( sizeof( struct AsyncPack ), MEMF_PUBLIC | MEMF_CLEAR ) ) )
+	{
+		if( closeIt )
+		{
+			Close( handle );
+		}
+
+		SetIoErr( ERROR_NO_FREE_STORE );
+		return( NULL );
+	}
+
+	/* the packed data is read and written through an ordinary async file */
+#ifdef ASIO_NOEXTERNALS
+	pack->ap_File = AS_OpenAsyncFH( handle, mode, bufferSize, closeIt, SysBase, DOSBase );
+#else
+	pack->ap_File = AS_OpenAsyncFH( handle, mode, bufferSize, closeIt );
+#endif
+
+	if( !pack->ap_File )
+	{
+		FreeVec( pack );
+		return( NULL );
+	}
+
+	return( pack );
+}
+
+
+LONG
+AS_ClosePack( struct AsyncPack *pack )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = pack->ap_File->af_SysBase;
+#endif
+	LONG	result;
+
+	result = CloseAsync( pack->ap_File );
+	FreeVec( pack );
+
+	return( result );
+}
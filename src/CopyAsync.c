@@ -0,0 +1,49 @@
+#include "async.h"
+
+
+_LIBCALL LONG
+CopyAsync( _REG( a0 ) AsyncFile *src, _REG( a1 ) AsyncFile *dst, _REG( d0 ) LONG length )
+{
+	LONG	totalBytes = 0;
+	LONG	bytes;
+
+	/* a negative length means "until EOF" */
+	while( length )
+	{
+		if( ( bytes = AS_FillBuffer( src ) ) <= 0 )
+		{
+			if( bytes < 0 )
+			{
+				return( -1 );
+			}
+
+			/* EOF */
+			break;
+		}
+
+		if( ( length > 0 ) && ( bytes > length ) )
+		{
+			bytes = length;
+		}
+
+		/* Move the data straight from the read buffer into the write
+		 * buffer. Both files keep their own packets in flight while we
+		 * do this, so the two devices work at the same time.
+		 */
+		if( WriteAsync( dst, src->af_Offset, bytes ) < 0 )
+		{
+			return( -1 );
+		}
+
+		src->af_Offset		+= bytes;
+		src->af_BytesLeft	-= bytes;
+		totalBytes		+= bytes;
+
+		if( length > 0 )
+		{
+			length -= bytes;
+		}
+	}
+
+	return( totalBytes );
+}
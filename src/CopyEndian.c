@@ -0,0 +1,59 @@
+#include "async.h"
+
+
+/* copy count elements of the given AEF_#? format from one buffer to the
+ * other, swapping the bytes of each element if the byte order in the file
+ * isn't the native one. Neither buffer needs to be aligned.
+ */
+VOID
+AS_CopyEndian( AsyncFile *file, UBYTE *from, UBYTE *to, LONG count, ULONG format )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = file->af_SysBase;
+#endif
+	static const UWORD	native = 0x0001;
+	LONG			size = format & AEF_SIZEMASK;
+
+	/* native is 0x00 0x01 in memory on big-endian machines like ours */
+	if( ( ( format & AEF_LITTLE ) != 0 ) == ( *( UBYTE * ) &native != 0 ) )
+	{
+		CopyMem( from, to, count * size );
+		return;
+	}
+
+	switch( size )
+	{
+		case 2:
+			for( ; count > 0; --count, from += 2, to += 2 )
+			{
+				to[ 0 ] = from[ 1 ];
+				to[ 1 ] = from[ 0 ];
+			}
+
+			break;
+
+		case 4:
+			for( ; count > 0; --count, from += 4, to += 4 )
+			{
+				to[ 0 ] = from[ 3 ];
+				to[ 1 ] = from[ 2 ];
+				to[ 2 ] = from[ 1 ];
+				to[ 3 ] = from[ 0 ];
+			}
+
+			break;
+
+		default:
+			for( ; count > 0; --count, from += size, to += size )
+			{
+				LONG	i;
+
+				for( i = 0; i < size; ++i )
+				{
+					to[ i ] = from[ size - 1 - i ];
+				}
+			}
+
+			break;
+	}
+}
@@ -0,0 +1,129 @@
+#include "async.h"
+
+
+_CALL LONG
+CountLinesAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG limit, _REG( a1 ) ULONG *lines, _REG( a2 ) ULONG *longest )
+{
+	UBYTE	*p, *end, *lineStart;
+	ULONG	numLines = 0;
+	ULONG	longestLine = 0;
+	ULONG	lineLength = 0;
+	ULONG	bits;
+	LONG	total = 0;
+	LONG	left;
+
+	while( ( limit < 0 ) || ( total < limit ) )
+	{
+		if( ( left = AS_FillBuffer( file ) ) < 0 )
+		{
+			return( -1 );
+		}
+
+		if( !left )
+		{
+			break;
+		}
+
+		if( ( limit >= 0 ) && ( left > limit - total ) )
+		{
+			left = limit - total;
+		}
+
+		p		= file->af_Offset;
+		end		= p + left;
+		lineStart	= p;
+
+		if( !longest )
+		{
+			/* Only the number of lines is needed, so go through the
+			 * buffer a longword at a time, and count the newline bits.
+			 */
+			while( ( p < end ) && ( ( ULONG ) p & 3 ) )
+			{
+				if( *p++ == '\n' )
+				{
+					++numLines;
+				}
+			}
+
+			while( end - p >= 4 )
+			{
+				bits = NEWLINES( *( ULONG * ) p );
+				p += 4;
+
+				if( bits )
+				{
+					bits >>= 7;
+					bits += bits >> 16;
+					bits += bits >> 8;
+					numLines += bits & 0xff;
+				}
+			}
+
+			while( p < end )
+			{
+				if( *p++ == '\n' )
+				{
+					++numLines;
+				}
+			}
+
+			/* remember if there is an unfinished line */
+			lineLength = ( end[ -1 ] != '\n' );
+		}
+		else
+		{
+			/* The line lengths are needed too. Longwords without a
+			 * newline are still skipped in one go.
+			 */
+			while( p < end )
+			{
+				if( !( ( ULONG ) p & 3 ) && ( end - p >= 4 ) && !NEWLINES( *( ULONG * ) p ) )
+				{
+					p += 4;
+					continue;
+				}
+
+				if( *p++ == '\n' )
+				{
+					lineLength += p - lineStart;
+					lineStart = p;
+					++numLines;
+
+					if( lineLength > longestLine )
+					{
+						longestLine = lineLength;
+					}
+
+					lineLength = 0;
+				}
+			}
+
+			lineLength += p - lineStart;
+		}
+
+		file->af_Offset		+= left;
+		file->af_BytesLeft	-= left;
+		total			+= left;
+	}
+
+	/* a last line without a newline counts too */
+	if( lineLength )
+	{
+		++numLines;
+
+		if( lineLength > longestLine )
+		{
+			longestLine = lineLength;
+		}
+	}
+
+	*lines = numLines;
+
+	if( longest )
+	{
+		*longest = longestLine;
+	}
+
+	return( total );
+}
@@ -0,0 +1,27 @@
+#include "async.h"
+
+
+/* make sure there is at least one unread byte in the current buffer,
+ * waiting for the next buffer to arrive if needed. Returns the number of
+ * bytes available in the buffer, 0 at EOF, or -1 on error.
+ */
+LONG
+AS_FillBuffer( AsyncFile *file )
+{
+	if( !file->af_BytesLeft )
+	{
+		LONG	bytes;
+
+		/* let ReadAsync() deal with the buffer flip */
+		if( ( bytes = ReadAsync( file, &bytes, 1 ) ) <= 0 )
+		{
+			return( bytes );
+		}
+
+		/* Unread byte */
+		--file->af_Offset;
+		++file->af_BytesLeft;
+	}
+
+	return( file->af_BytesLeft );
+}
@@ -0,0 +1,183 @@
+#include "async.h"
+
+
+/* longest pattern FindAsync() can look for */
+#define MAX_PATTERN	255
+
+/* case folding for ISO-8859-1 */
+#define FOLD(c)	( ( ( ( c ) >= 'a' ) && ( ( c ) <= 'z' ) ) || \
+		  ( ( ( c ) >= 0xe0 ) && ( ( c ) <= 0xfe ) && ( ( c ) != 0xf7 ) ) ? \
+		  ( c ) - 0x20 : ( c ) )
+
+
+static BOOL
+Equal( UBYTE *text, UBYTE *pattern, LONG length, BOOL noCase )
+{
+	UBYTE	c;
+
+	while( length-- )
+	{
+		c = *text++;
+
+		if( noCase )
+		{
+			c = FOLD( c );
+		}
+
+		if( c != *pattern++ )
+		{
+			return( FALSE );
+		}
+	}
+
+	return( TRUE );
+}
+
+
+/* Boyer-Moore-Horspool search. Returns the offset of the first match in
+ * text, or -1 if there is none. The pattern has already been folded for
+ * a case-insensitive search.
+ */
+static LONG
+Search( UBYTE *text, LONG length, UBYTE *pattern, LONG patternLength, UBYTE *skip, BOOL noCase )
+{
+	LONG	last = patternLength - 1;
+	LONG	pos = 0;
+	UBYTE	c;
+
+	while( pos + patternLength <= length )
+	{
+		c = text[ pos + last ];
+
+		if( noCase )
+		{
+			c = FOLD( c );
+		}
+
+		if( ( c == pattern[ last ] ) && Equal( text + pos, pattern, last, noCase ) )
+		{
+			return( pos );
+		}
+
+		pos += skip[ c ];
+	}
+
+	return( -1 );
+}
+
+
+_LIBCALL LONG
+FindAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR pattern, _REG( d0 ) LONG length, _REG( d1 ) ULONG flags )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = file->af_SysBase;
+	struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+	UBYTE	pat[ MAX_PATTERN ];
+	UBYTE	skip[ 256 ];
+	UBYTE	window[ MAX_PATTERN ];
+	UBYTE	*p;
+	LONG	keep = 0;
+	LONG	skipped = 0;
+	LONG	left, need, i, j;
+	BOOL	noCase = ( flags & FINDF_NOCASE ) != 0;
+
+	if( ( length <= 0 ) || ( length > MAX_PATTERN ) )
+	{
+		SetIoErr( ERROR_BAD_NUMBER );
+		return( -1 );
+	}
+
+	for( i = 0; i < length; ++i )
+	{
+		pat[ i ] = noCase ? FOLD( ( ( UBYTE * ) pattern )[ i ] ) : ( ( UBYTE * ) pattern )[ i ];
+	}
+
+	for( i = 0; i < 256; ++i )
+	{
+		skip[ i ] = ( UBYTE ) length;
+	}
+
+	for( i = 0; i < length - 1; ++i )
+	{
+		skip[ pat[ i ] ] = ( UBYTE ) ( length - 1 - i );
+	}
+
+	for( ;; )
+	{
+		if( ( left = AS_FillBuffer( file ) ) <= 0 )
+		{
+			if( !left )
+			{
+				SetIoErr( ERROR_OBJECT_NOT_FOUND );
+			}
+
+			return( -1 );
+		}
+
+		p = file->af_Offset;
+
+		/* The window holds the last bytes of the previous buffer(s), each
+		 * of which could be the start of a match that goes on here.
+		 */
+		if( keep )
+		{
+			for( i = 0; i < keep; ++i )
+			{
+				need = length - ( keep - i );
+
+				if( need > left )
+				{
+					/* this buffer is too short to tell */
+					break;
+				}
+
+				if( Equal( window + i, pat, keep - i, noCase ) && Equal( p, pat + keep - i, need, noCase ) )
+				{
+					file->af_Offset		+= need;
+					file->af_BytesLeft	-= need;
+					return( skipped + i );
+				}
+			}
+
+			if( i < keep )
+			{
+				/* keep the undecided bytes, and all of this buffer */
+				skipped += i;
+				keep -= i;
+
+				for( j = 0; j < keep; ++j )
+				{
+					window[ j ] = window[ i + j ];
+				}
+
+				CopyMem( p, window + keep, left );
+				keep += left;
+
+				file->af_Offset		+= left;
+				file->af_BytesLeft	= 0;
+				continue;
+			}
+
+			skipped += keep;
+			keep = 0;
+		}
+
+		if( ( i = Search( p, left, pat, length, skip, noCase ) ) >= 0 )
+		{
+			file->af_Offset		+= i + length;
+			file->af_BytesLeft	-= i + length;
+			return( skipped + i );
+		}
+
+		/* the last few bytes may be the start of a match that is only
+		 * complete in the next buffer
+		 */
+		keep = MIN( left, length - 1 );
+		CopyMem( p + left - keep, window, keep );
+		skipped += left - keep;
+
+		file->af_Offset		+= left;
+		file->af_BytesLeft	= 0;
+	}
+}
@@ -0,0 +1,151 @@
+#include "async.h"
+
+
+/* the block sizes of the last few volumes files were opened on. An entry
+ * only counts if the same volume is still in the drive, so a disk change
+ * makes it go stale by itself.
+ */
+struct Geometry
+{
+	struct MsgPort		*g_Handler;
+	struct DosList		*g_Volume;
+	struct DateStamp	g_VolumeDate;
+	LONG			g_BlockSize;
+};
+
+static struct Geometry	GeometryCache[ GEOMETRY_CACHESIZE ];
+static ULONG		NextGeometry;
+
+
+/* find the volume the handler has mounted right now. Returns FALSE if it
+ * has none (e.g. a console or pipe handler), in which case nothing is cached.
+ */
+#ifdef ASIO_NOEXTERNALS
+static BOOL
+FindVolume( struct MsgPort *handler, struct Geometry *geometry, struct DosLibrary *DOSBase )
+#else
+static BOOL
+FindVolume( struct MsgPort *handler, struct Geometry *geometry )
+#endif
+{
+	struct DosList	*dl;
+
+	geometry->g_Handler	= handler;
+	geometry->g_Volume	= NULL;
+
+	if( handler )
+	{
+		dl = LockDosList( LDF_VOLUMES | LDF_READ );
+
+		while( dl = NextDosEntry( dl, LDF_VOLUMES ) )
+		{
+			if( dl->dol_Task == handler )
+			{
+				geometry->g_Volume	= dl;
+				geometry->g_VolumeDate	= dl->dol_misc.dol_volume.dol_VolumeDate;
+				break;
+			}
+		}
+
+		UnLockDosList( LDF_VOLUMES | LDF_READ );
+	}
+
+	return( ( BOOL ) ( geometry->g_Volume != NULL ) );
+}
+
+
+/* Returns TRUE if both name the same volume on the same handler */
+static BOOL
+SameVolume( struct Geometry *a, struct Geometry *b )
+{
+	return( ( BOOL ) ( ( a->g_Handler == b->g_Handler ) &&
+		( a->g_Volume == b->g_Volume ) &&
+		( a->g_VolumeDate.ds_Days == b->g_VolumeDate.ds_Days ) &&
+		( a->g_VolumeDate.ds_Minute == b->g_VolumeDate.ds_Minute ) &&
+		( a->g_VolumeDate.ds_Tick == b->g_VolumeDate.ds_Tick ) ) );
+}
+
+
+/* Returns the block size of the volume handler has mounted, if it is known,
+ * or 0 if the caller has to ask with Info()
+ */
+#ifdef ASIO_NOEXTERNALS
+LONG
+AS_CachedBlockSize( struct MsgPort *handler, struct ExecBase *SysBase, struct DosLibrary *DOSBase )
+#else
+LONG
+AS_CachedBlockSize( struct MsgPort *handler )
+#endif
+{
+	struct Geometry	current;
+	LONG		blockSize = 0;
+	LONG		i;
+
+#ifdef ASIO_NOEXTERNALS
+	if( FindVolume( handler, &current, DOSBase ) )
+#else
+	if( FindVolume( handler, &current ) )
+#endif
+	{
+		/* the cache is shared by all tasks using the library */
+		Forbid();
+
+		for( i = 0; i < GEOMETRY_CACHESIZE; ++i )
+		{
+			if( SameVolume( &GeometryCache[ i ], &current ) )
+			{
+				blockSize = GeometryCache[ i ].g_BlockSize;
+				break;
+			}
+		}
+
+		Permit();
+	}
+
+	return( blockSize );
+}
+
+
+/* remember the block size Info() returned for the volume handler has
+ * mounted. An older entry for the same handler (another disk) is replaced,
+ * otherwise the oldest entry is.
+ */
+#ifdef ASIO_NOEXTERNALS
+VOID
+AS_CacheBlockSize( struct MsgPort *handler, LONG blockSize, struct ExecBase *SysBase, struct DosLibrary *DOSBase )
+#else
+VOID
+AS_CacheBlockSize( struct MsgPort *handler, LONG blockSize )
+#endif
+{
+	struct Geometry	current;
+	LONG		i;
+
+#ifdef ASIO_NOEXTERNALS
+	if( ( blockSize > 0 ) && FindVolume( handler, &current, DOSBase ) )
+#else
+	if( ( blockSize > 0 ) && FindVolume( handler, &current ) )
+#endif
+	{
+		current.g_BlockSize = blockSize;
+
+		Forbid();
+
+		for( i = 0; i < GEOMETRY_CACHESIZE; ++i )
+		{
+			if( GeometryCache[ i ].g_Handler == handler )
+			{
+				break;
+			}
+		}
+
+		if( i == GEOMETRY_CACHESIZE )
+		{
+			i = NextGeometry++ % GEOMETRY_CACHESIZE;
+		}
+
+		GeometryCache[ i ] = current;
+
+		Permit();
+	}
+}
@@ -0,0 +1,238 @@
+#include "async.h"
+
+
+/* set up the port of a file, and of the file a compressed file reads or
+ * writes through, to signal the group, or to go back to the SIGB_SINGLE
+ * trick when group is NULL
+ */
+static VOID
+SetPort( AsyncFile *file, struct AsyncGroup *group )
+{
+	file->af_Group = group;
+
+	if( group )
+	{
+		file->af_PacketPort.mp_SigBit	= group->ag_SigBit;
+		file->af_PacketPort.mp_SigTask	= group->ag_Task;
+	}
+	else
+	{
+		file->af_PacketPort.mp_SigBit	= SIGB_SINGLE;
+	}
+
+	file->af_PacketPort.mp_Flags = IDLE_PORT_FLAGS( file );
+
+	if( file->af_Packed )
+	{
+		SetPort( file->af_Packed->ap_File, group );
+	}
+}
+
+
+/* Returns TRUE if the next read from (or write to) file won't have to wait
+ * for a packet to come back. Also used by TryReadAsync() and friends.
+ */
+BOOL
+AS_FileReady( AsyncFile *file )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = file->af_SysBase;
+#endif
+	struct AsyncTee	*tee;
+	struct Node	*node;
+	LONG		pending;
+
+	if( file->af_BytesLeft > 0 )
+	{
+		return( TRUE );
+	}
+
+	if( file->af_Packed )
+	{
+		return( AS_FileReady( file->af_Packed->ap_File ) );
+	}
+
+	/* a packet held by a scheduler is sent now, if the device is free */
+	if( file->af_Ticket )
+	{
+		AS_ReleasePacket( file, FALSE );
+	}
+
+	pending = file->af_PacketPending ? 1 : 0;
+
+	for( tee = file->af_Tees; tee; tee = tee->at_Next )
+	{
+		if( tee->at_PacketPending )
+		{
+			++pending;
+		}
+	}
+
+	/* all the packets that are out must be back at the port */
+	Forbid();
+
+	for( node = file->af_PacketPort.mp_MsgList.lh_Head; node->ln_Succ && pending; node = node->ln_Succ )
+	{
+		--pending;
+	}
+
+	Permit();
+
+	return( ( BOOL ) !pending );
+}
+
+
+#ifdef ASIO_NOEXTERNALS
+_LIBCALL struct AsyncGroup *
+CreateAsyncGroup( _REG( a0 ) struct ExecBase *SysBase )
+#else
+_LIBCALL struct AsyncGroup *
+CreateAsyncGroup( VOID )
+#endif
+{
+	struct AsyncGroup	*group;
+
+	if( group = AllocVec( sizeof( struct AsyncGroup ), MEMF_PUBLIC | MEMF_CLEAR ) )
+	{
+		if( ( group->ag_SigBit = AllocSignal( -1 ) ) >= 0 )
+		{
+			group->ag_SignalMask	= 1UL << group->ag_SigBit;
+			group->ag_Task		= FindTask( NULL );
+#ifdef ASIO_NOEXTERNALS
+			group->ag_SysBase	= SysBase;
+#endif
+		}
+		else
+		{
+			FreeVec( group );
+			group = NULL;
+		}
+	}
+
+	return( group );
+}
+
+
+_LIBCALL VOID
+DeleteAsyncGroup( _REG( a0 ) struct AsyncGroup *group )
+{
+	if( group )
+	{
+#ifdef ASIO_NOEXTERNALS
+		struct ExecBase	*SysBase = group->ag_SysBase;
+#endif
+		while( group->ag_Files )
+		{
+			AttachAsync( group->ag_Files, NULL );
+		}
+
+		FreeSignal( group->ag_SigBit );
+		FreeVec( group );
+	}
+}
+
+
+_LIBCALL VOID
+AttachAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) struct AsyncGroup *group )
+{
+	struct AsyncGroup	*old = file->af_Group;
+	AsyncFile		**link;
+
+	/* a file can't be in a group and a scheduler at the same time */
+	if( group )
+	{
+		ScheduleAsync( file, NULL );
+	}
+
+	if( old )
+	{
+		/* the file a compressed file goes through is not in the list */
+		for( link = &old->ag_Files; *link; link = &( *link )->af_NextInGroup )
+		{
+			if( *link == file )
+			{
+				*link = file->af_NextInGroup;
+				break;
+			}
+		}
+
+		if( old->ag_Last == file )
+		{
+			old->ag_Last = NULL;
+		}
+
+		file->af_NextInGroup = NULL;
+	}
+
+	SetPort( file, group );
+
+	if( group )
+	{
+		file->af_NextInGroup	= group->ag_Files;
+		group->ag_Files		= file;
+	}
+}
+
+
+_LIBCALL AsyncFile *
+PollAsync( _REG( a0 ) struct AsyncGroup *group )
+{
+	AsyncFile	*file, *start;
+
+	if( !group->ag_Files )
+	{
+		return( NULL );
+	}
+
+	/* start after the file returned last time, so that one busy file
+	 * can't keep the others waiting
+	 */
+	if( !group->ag_Last || !( start = group->ag_Last->af_NextInGroup ) )
+	{
+		start = group->ag_Files;
+	}
+
+	file = start;
+
+	do
+	{
+		if( AS_FileReady( file ) )
+		{
+			group->ag_Last = file;
+			return( file );
+		}
+
+		if( !( file = file->af_NextInGroup ) )
+		{
+			file = group->ag_Files;
+		}
+	}
+	while( file != start );
+
+	return( NULL );
+}
+
+
+_LIBCALL AsyncFile *
+WaitAnyAsync( _REG( a0 ) struct AsyncGroup *group )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = group->ag_SysBase;
+#endif
+	AsyncFile	*file;
+
+	while( group->ag_Files )
+	{
+		if( file = PollAsync( group ) )
+		{
+			return( file );
+		}
+
+		/* a packet coming back after the check sets the signal, so it
+		 * can't be missed
+		 */
+		Wait( group->ag_SignalMask );
+	}
+
+	return( NULL );
+}
@@ -0,0 +1,64 @@
+#include "async.h"
+
+
+_CALL LONG
+ReadInPlaceAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR *buffer, _REG( d0 ) LONG numBytes )
+{
+	LONG	left;
+
+	if( ( left = AS_FillBuffer( file ) ) <= 0 )
+	{
+		return( left );
+	}
+
+	if( ( numBytes >= 0 ) && ( numBytes < left ) )
+	{
+		left = numBytes;
+	}
+
+	/* hand out the bytes right where they are in the buffer */
+	*buffer			= file->af_Offset;
+	file->af_Offset		+= left;
+	file->af_BytesLeft	-= left;
+
+	return( left );
+}
+
+
+_CALL LONG
+WriteInPlaceAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR *buffer, _REG( d0 ) LONG numBytes )
+{
+	LONG	space;
+
+	if( !file->af_BytesLeft )
+	{
+		UBYTE	dummy = 0;
+
+		/* let WriteAsync() deal with the buffer flip */
+		if( WriteAsync( file, &dummy, 1 ) < 0 )
+		{
+			return( -1 );
+		}
+
+		/* take the byte back, unless WriteAsync() threw it away (NIL:) */
+		if( file->af_BytesLeft < file->af_BufferSize )
+		{
+			--file->af_Offset;
+			++file->af_BytesLeft;
+		}
+	}
+
+	space = file->af_BytesLeft;
+
+	if( ( numBytes >= 0 ) && ( numBytes < space ) )
+	{
+		space = numBytes;
+	}
+
+	/* the caller fills in the space before the next call */
+	*buffer			= file->af_Offset;
+	file->af_Offset		+= space;
+	file->af_BytesLeft	-= space;
+
+	return( space );
+}
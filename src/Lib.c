@@ -74,6 +74,54 @@ static const APTR FuncTable[] =
 	FGetsAsync,
 	FGetsLenAsync,
 	PeekAsync,
+	ReadVAsync,
+	WriteVAsync,
+	WriteLinesAsync,
+	VFPrintfAsync,
+	ReadLongAsync,
+	ReadLongsAsync,
+	ReadEndianAsync,
+	WriteEndianAsync,
+	PeekBitsAsync,
+	ReadBitsAsync,
+	WriteBitsAsync,
+	AlignBitsAsync,
+	ReadVarIntAsync,
+	WriteVarIntAsync,
+	CopyAsync,
+	TeeAsync,
+	SetDigestAsync,
+	GetDigestAsync,
+	FindAsync,
+	CountLinesAsync,
+	BuildLineIndexAsync,
+	LoadLineIndexAsync,
+	ReadLineAtAsync,
+	ReadInPlaceAsync,
+	WriteInPlaceAsync,
+	CreateAsyncGroup,
+	DeleteAsyncGroup,
+	AttachAsync,
+	WaitAnyAsync,
+	PollAsync,
+	TryReadAsync,
+	TryWriteAsync,
+	ReadSomeAsync,
+	OpenAsyncBatch,
+	NextAsyncBatch,
+	EndAsyncBatch,
+	OpenAsyncDir,
+	ReadAsyncDir,
+	CloseAsyncDir,
+	OpenAsyncDirBatch,
+	NameAsyncBatch,
+	CreateAsyncScheduler,
+	DeleteAsyncScheduler,
+	ScheduleAsync,
+	SetPriorityAsync,
+	OpenAsyncScan,
+	ReadAsyncScan,
+	CloseAsyncScan,
 	( APTR ) -1	/* Terminate the table */
 };
 
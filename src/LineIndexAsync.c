@@ -0,0 +1,257 @@
+#include "async.h"
+
+
+/* an index file starts with these four longwords, followed by the offsets */
+#define INDEX_MAGIC	0x414c4958	/* "ALIX" */
+#define INDEX_HEADER	4
+
+/* the number of offsets room is made for at first */
+#define INITIAL_COUNT	256
+
+/* the most offsets an index can have without its size overflowing */
+#define MAX_COUNT	( ( 0x7fffffffUL - sizeof( struct AsyncLineIndex ) ) / sizeof( LONG ) )
+
+
+/* allocate an index, with room for count offsets */
+static struct AsyncLineIndex *
+AllocIndex( AsyncFile *file, ULONG every, ULONG lines, ULONG count )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = file->af_SysBase;
+	struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+	struct AsyncLineIndex	*index;
+
+	if( !( index = AllocVec( sizeof( struct AsyncLineIndex ) + count * sizeof( LONG ), MEMF_ANY ) ) )
+	{
+		SetIoErr( ERROR_NO_FREE_STORE );
+		return( NULL );
+	}
+
+	index->ali_Every	= every;
+	index->ali_Lines	= lines;
+	index->ali_Count	= count;
+	index->ali_Offsets	= ( LONG * ) ( index + 1 );
+
+	return( index );
+}
+
+
+_LIBCALL struct AsyncLineIndex *
+BuildLineIndexAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG every, _REG( a1 ) AsyncFile *indexFile )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = file->af_SysBase;
+	struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+	struct AsyncLineIndex	*index = NULL;
+	LONG			*offsets, *more;
+	UBYTE			*p, *end;
+	ULONG			header[ INDEX_HEADER ];
+	ULONG			lines = 0;
+	ULONG			count = 0;
+	ULONG			max = INITIAL_COUNT;
+	LONG			untilMark = every;
+	LONG			position;
+	LONG			left;
+	BOOL			partial = FALSE;
+
+	if( every <= 0 )
+	{
+		SetIoErr( ERROR_BAD_NUMBER );
+		return( NULL );
+	}
+
+	if( ( position = SeekAsync( file, 0, MODE_CURRENT ) ) < 0 )
+	{
+		return( NULL );
+	}
+
+	if( !( offsets = AllocVec( max * sizeof( LONG ), MEMF_ANY ) ) )
+	{
+		SetIoErr( ERROR_NO_FREE_STORE );
+		return( NULL );
+	}
+
+	offsets[ count++ ] = position;
+
+	while( ( left = AS_FillBuffer( file ) ) > 0 )
+	{
+		p	= file->af_Offset;
+		end	= p + left;
+
+		while( p < end )
+		{
+			/* skip longwords without a newline, like CountLinesAsync() */
+			if( !( ( ULONG ) p & 3 ) && ( end - p >= 4 ) && !NEWLINES( *( ULONG * ) p ) )
+			{
+				p += 4;
+				continue;
+			}
+
+			if( *p++ != '\n' )
+			{
+				continue;
+			}
+
+			++lines;
+
+			if( --untilMark )
+			{
+				continue;
+			}
+
+			untilMark = every;
+
+			if( count == max )
+			{
+				if( !( more = AllocVec( max * 2 * sizeof( LONG ), MEMF_ANY ) ) )
+				{
+					FreeVec( offsets );
+					SetIoErr( ERROR_NO_FREE_STORE );
+					return( NULL );
+				}
+
+				CopyMem( offsets, more, max * sizeof( LONG ) );
+				FreeVec( offsets );
+				offsets = more;
+				max *= 2;
+			}
+
+			offsets[ count++ ] = position + ( p - file->af_Offset );
+		}
+
+		partial			= ( end[ -1 ] != '\n' );
+		position		+= left;
+		file->af_Offset		+= left;
+		file->af_BytesLeft	= 0;
+	}
+
+	if( !left )
+	{
+		/* a last line without a newline counts too */
+		if( partial )
+		{
+			++lines;
+		}
+
+		/* don't keep an offset for the end of the file */
+		if( ( count > 1 ) && ( ( count - 1 ) * every >= lines ) )
+		{
+			--count;
+		}
+
+		if( index = AllocIndex( file, every, lines, count ) )
+		{
+			CopyMem( offsets, index->ali_Offsets, count * sizeof( LONG ) );
+
+			if( indexFile )
+			{
+				header[ 0 ] = INDEX_MAGIC;
+				header[ 1 ] = every;
+				header[ 2 ] = lines;
+				header[ 3 ] = count;
+
+				if( ( WriteBE32ArrayAsync( indexFile, header, INDEX_HEADER ) < 0 ) ||
+					( WriteBE32ArrayAsync( indexFile, index->ali_Offsets, count ) < 0 ) )
+				{
+					FreeVec( index );
+					index = NULL;
+				}
+			}
+		}
+	}
+
+	FreeVec( offsets );
+	return( index );
+}
+
+
+_LIBCALL struct AsyncLineIndex *
+LoadLineIndexAsync( _REG( a0 ) AsyncFile *indexFile )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = indexFile->af_SysBase;
+	struct DosLibrary	*DOSBase = indexFile->af_DOSBase;
+#endif
+	struct AsyncLineIndex	*index;
+	ULONG			header[ INDEX_HEADER ];
+	LONG			result;
+
+	if( ( result = ReadBE32ArrayAsync( indexFile, header, INDEX_HEADER ) ) != INDEX_HEADER )
+	{
+		if( result >= 0 )
+		{
+			SetIoErr( ERROR_OBJECT_WRONG_TYPE );
+		}
+
+		return( NULL );
+	}
+
+	if( ( header[ 0 ] != INDEX_MAGIC ) || !header[ 1 ] || !header[ 3 ] || ( header[ 3 ] > MAX_COUNT ) )
+	{
+		SetIoErr( ERROR_OBJECT_WRONG_TYPE );
+		return( NULL );
+	}
+
+	/* there is an offset for every ali_Every lines, which ReadLineAtAsync()
+	 * relies on. An empty file still has one, for its start.
+	 */
+	if( header[ 2 ] ? ( ( header[ 2 ] - 1 ) / header[ 1 ] + 1 != header[ 3 ] ) : ( header[ 3 ] != 1 ) )
+	{
+		SetIoErr( ERROR_OBJECT_WRONG_TYPE );
+		return( NULL );
+	}
+
+	if( !( index = AllocIndex( indexFile, header[ 1 ], header[ 2 ], header[ 3 ] ) ) )
+	{
+		return( NULL );
+	}
+
+	if( ( result = ReadBE32ArrayAsync( indexFile, index->ali_Offsets, index->ali_Count ) ) != index->ali_Count )
+	{
+		if( result >= 0 )
+		{
+			SetIoErr( ERROR_OBJECT_WRONG_TYPE );
+		}
+
+		FreeVec( index );
+		return( NULL );
+	}
+
+	return( index );
+}
+
+
+_CALL LONG
+ReadLineAtAsync(
+	_REG( a0 ) AsyncFile *file,
+	_REG( a1 ) struct AsyncLineIndex *index,
+	_REG( d0 ) ULONG line,
+	_REG( a2 ) STRPTR buffer,
+	_REG( d1 ) LONG size )
+{
+	ULONG	skip;
+
+	if( line >= index->ali_Lines )
+	{
+		/* just like reading past the last line */
+		return( 0 );
+	}
+
+	if( SeekAsync( file, index->ali_Offsets[ line / index->ali_Every ], MODE_START ) < 0 )
+	{
+		return( -1 );
+	}
+
+	/* the wanted line is at most ali_Every - 1 lines further on */
+	for( skip = line % index->ali_Every; skip; --skip )
+	{
+		if( FindAsync( file, "\n", 1, 0 ) < 0 )
+		{
+			return( -1 );
+		}
+	}
+
+	return( ReadLineAsync( file, buffer, size ) );
+}
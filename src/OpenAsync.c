@@ -24,7 +24,7 @@ OpenAsync(
 	BPTR		handle;
 	AsyncFile	*file = NULL;
 
-	if( handle = Open( fileName, PrivateOpenModes[ mode ] ) )
+	if( handle = Open( fileName, PrivateOpenModes[ OPEN_MODE( mode ) ] ) )
 	{
 #ifdef ASIO_NOEXTERNALS
 		file = AS_OpenAsyncFH( handle, mode, bufferSize, TRUE, SysBase, DOSBase );
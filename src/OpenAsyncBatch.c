@@ -0,0 +1,406 @@
+#include "async.h"
+
+
+/* send the open packet for file number index of the batch. If the packet
+ * can't be used, the file is opened right away instead.
+ */
+static VOID
+StartOpen( struct AsyncBatch *batch, LONG index, STRPTR name )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = batch->ab_SysBase;
+	struct DosLibrary	*DOSBase = batch->ab_DOSBase;
+#endif
+	static const LONG	Actions[] =
+	{
+		ACTION_FINDINPUT, ACTION_FINDOUTPUT, ACTION_FINDUPDATE
+	};
+	struct AsyncOpening	*opening = &batch->ab_Opening[ index % BATCH_AHEAD ];
+	UBYTE			*bstr = ( UBYTE * ) opening->ao_Name;
+	LONG			length = strlen( name );
+	struct MsgPort		*port = NULL;
+	BPTR			dirLock = NULL;
+	BPTR			oldDir;
+
+	opening->ao_Index	= index;
+	opening->ao_File	= NULL;
+	opening->ao_Error	= 0;
+	opening->ao_Handle	= NULL;
+	opening->ao_Pending	= FALSE;
+	opening->ao_DevProc	= NULL;
+
+	/* the name is kept null-terminated after the length, for
+	 * NameAsyncBatch()
+	 */
+	if( length < sizeof( opening->ao_Name ) - 1 )
+	{
+		bstr[ 0 ] = length;
+		CopyMem( name, bstr + 1, length + 1 );
+
+		if( batch->ab_Dir )
+		{
+			/* a name from the directory is looked up from its lock */
+			dirLock	= batch->ab_Dir->ad_Lock;
+			port	= ( ( struct FileLock * ) BADDR( dirLock ) )->fl_Task;
+		}
+		else if( opening->ao_DevProc = GetDeviceProc( name, NULL ) )
+		{
+			dirLock	= opening->ao_DevProc->dvp_Lock;
+			port	= opening->ao_DevProc->dvp_Port;
+		}
+
+		/* NIL: and the like have no handler to send the packet to */
+		if( port && ( opening->ao_Handle = AllocDosObject( DOS_FILEHANDLE, NULL ) ) )
+		{
+			/* this is what Open() sends, but we don't wait for the reply */
+			opening->ao_Handle->fh_Type			= port;
+			opening->ao_Packet.sp_Msg.mn_Node.ln_Name	= ( STRPTR ) &opening->ao_Packet.sp_Pkt;
+			opening->ao_Packet.sp_Msg.mn_Node.ln_Type	= NT_MESSAGE;
+			opening->ao_Packet.sp_Msg.mn_Length		= sizeof( struct StandardPacket );
+			opening->ao_Packet.sp_Pkt.dp_Link		= &opening->ao_Packet.sp_Msg;
+			opening->ao_Packet.sp_Pkt.dp_Port		= &batch->ab_Port;
+			opening->ao_Packet.sp_Pkt.dp_Type		= Actions[ OPEN_MODE( batch->ab_Mode ) ];
+			opening->ao_Packet.sp_Pkt.dp_Arg1		= MKBADDR( opening->ao_Handle );
+			opening->ao_Packet.sp_Pkt.dp_Arg2		= dirLock;
+			opening->ao_Packet.sp_Pkt.dp_Arg3		= MKBADDR( bstr );
+
+			PutMsg( port, &opening->ao_Packet.sp_Msg );
+			opening->ao_Pending = TRUE;
+			return;
+		}
+
+		FreeDeviceProc( opening->ao_DevProc );
+		opening->ao_DevProc = NULL;
+	}
+	else
+	{
+		bstr[ 0 ] = 0;
+		bstr[ 1 ] = 0;
+	}
+
+	if( batch->ab_Dir )
+	{
+		oldDir = CurrentDir( batch->ab_Dir->ad_Lock );
+	}
+
+#ifdef ASIO_NOEXTERNALS
+	opening->ao_File = OpenAsync( name, batch->ab_Mode, batch->ab_BufferSize, SysBase, DOSBase );
+#else
+	opening->ao_File = OpenAsync( name, batch->ab_Mode, batch->ab_BufferSize );
+#endif
+
+	if( batch->ab_Dir )
+	{
+		CurrentDir( oldDir );
+	}
+
+	if( !opening->ao_File )
+	{
+		opening->ao_Error = IoErr();
+	}
+}
+
+
+/* the open packet of a file has come back. Set up the AsyncFile, which
+ * sends out its first read at once.
+ */
+static VOID
+FinishOpen( struct AsyncBatch *batch, struct AsyncOpening *opening )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = batch->ab_SysBase;
+	struct DosLibrary	*DOSBase = batch->ab_DOSBase;
+#endif
+	BPTR	handle;
+
+	opening->ao_Pending = FALSE;
+
+	if( opening->ao_Packet.sp_Pkt.dp_Res1 )
+	{
+		handle = MKBADDR( opening->ao_Handle );
+
+#ifdef ASIO_NOEXTERNALS
+		if( !( opening->ao_File = AS_OpenAsyncFH( handle, batch->ab_Mode, batch->ab_BufferSize, TRUE, SysBase, DOSBase ) ) )
+#else
+		if( !( opening->ao_File = AS_OpenAsyncFH( handle, batch->ab_Mode, batch->ab_BufferSize, TRUE ) ) )
+#endif
+		{
+			/* the handle has been closed already */
+			opening->ao_Error = IoErr();
+		}
+	}
+	else
+	{
+		FreeDosObject( DOS_FILEHANDLE, opening->ao_Handle );
+		opening->ao_Error = opening->ao_Packet.sp_Pkt.dp_Res2;
+
+		/* the other directories of a multi-directory assign are left
+		 * to Open()
+		 */
+		if( ( opening->ao_Error == ERROR_OBJECT_NOT_FOUND ) && opening->ao_DevProc &&
+			( opening->ao_DevProc->dvp_Flags & DVPF_ASSIGN ) )
+		{
+#ifdef ASIO_NOEXTERNALS
+			if( opening->ao_File = OpenAsync( batch->ab_Names[ opening->ao_Index ], batch->ab_Mode, batch->ab_BufferSize, SysBase, DOSBase ) )
+#else
+			if( opening->ao_File = OpenAsync( batch->ab_Names[ opening->ao_Index ], batch->ab_Mode, batch->ab_BufferSize ) )
+#endif
+			{
+				opening->ao_Error = 0;
+			}
+		}
+	}
+
+	opening->ao_Handle = NULL;
+	FreeDeviceProc( opening->ao_DevProc );
+	opening->ao_DevProc = NULL;
+}
+
+
+/* take care of the open packets that have come back. If wait is set, wait
+ * for at least one.
+ */
+static VOID
+CollectOpens( struct AsyncBatch *batch, BOOL wait )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = batch->ab_SysBase;
+#endif
+	struct Message	*msg;
+	LONG		i;
+
+	if( wait )
+	{
+		batch->ab_Port.mp_Flags = PA_SIGNAL;
+		WaitPort( &batch->ab_Port );
+		batch->ab_Port.mp_Flags = PA_IGNORE;
+	}
+
+	while( msg = GetMsg( &batch->ab_Port ) )
+	{
+		for( i = 0; i < BATCH_AHEAD; ++i )
+		{
+			if( msg == &batch->ab_Opening[ i ].ao_Packet.sp_Msg )
+			{
+				FinishOpen( batch, &batch->ab_Opening[ i ] );
+			}
+		}
+	}
+}
+
+
+/* start opening the next file of the batch, if there is one. The files of
+ * a directory are taken as they are read, skipping anything else.
+ */
+static BOOL
+StartNext( struct AsyncBatch *batch )
+{
+	struct ExAllData	*entry;
+
+	if( batch->ab_Dir )
+	{
+		do
+		{
+			if( !( entry = ReadAsyncDir( batch->ab_Dir ) ) )
+			{
+				return( FALSE );
+			}
+		}
+		while( ( batch->ab_Dir->ad_Type >= ED_TYPE ) && ( entry->ed_Type >= 0 ) );
+
+		StartOpen( batch, batch->ab_Sent++, entry->ed_Name );
+	}
+	else
+	{
+		if( batch->ab_Sent >= batch->ab_Count )
+		{
+			return( FALSE );
+		}
+
+		StartOpen( batch, batch->ab_Sent, batch->ab_Names[ batch->ab_Sent ] );
+		++batch->ab_Sent;
+	}
+
+	return( TRUE );
+}
+
+
+/* set up a new batch; the files are taken from names, or from dir */
+#ifdef ASIO_NOEXTERNALS
+static struct AsyncBatch *
+NewBatch( STRPTR *names, LONG count, struct AsyncDir *dir, OpenModes mode, LONG bufferSize, struct ExecBase *SysBase, struct DosLibrary *DOSBase )
+#else
+static struct AsyncBatch *
+NewBatch( STRPTR *names, LONG count, struct AsyncDir *dir, OpenModes mode, LONG bufferSize )
+#endif
+{
+	struct AsyncBatch	*batch;
+	LONG			i;
+
+	if( !( batch = AllocVec( sizeof( struct AsyncBatch ), MEMF_PUBLIC | MEMF_CLEAR ) ) )
+	{
+		SetIoErr( ERROR_NO_FREE_STORE );
+		return( NULL );
+	}
+
+	batch->ab_Names		= names;
+	batch->ab_Dir		= dir;
+	batch->ab_Count		= count;
+	batch->ab_Mode		= mode;
+	batch->ab_BufferSize	= bufferSize;
+#ifdef ASIO_NOEXTERNALS
+	batch->ab_SysBase	= SysBase;
+	batch->ab_DOSBase	= DOSBase;
+#endif
+
+	/* the replies come back to a port set up like the one in AsyncFile */
+	batch->ab_Port.mp_MsgList.lh_Head	= ( struct Node * ) &batch->ab_Port.mp_MsgList.lh_Tail;
+	batch->ab_Port.mp_MsgList.lh_Tail	= NULL;
+	batch->ab_Port.mp_MsgList.lh_TailPred	= ( struct Node * ) &batch->ab_Port.mp_MsgList.lh_Head;
+	batch->ab_Port.mp_Node.ln_Type		= NT_MSGPORT;
+	batch->ab_Port.mp_Flags			= PA_IGNORE;
+	batch->ab_Port.mp_SigBit		= SIGB_SINGLE;
+	batch->ab_Port.mp_SigTask		= FindTask( NULL );
+
+	for( i = 0; ( i < BATCH_AHEAD ) && StartNext( batch ); ++i )
+	{
+	}
+
+	return( batch );
+}
+
+
+#ifdef ASIO_NOEXTERNALS
+_LIBCALL struct AsyncBatch *
+OpenAsyncBatch(
+	_REG( a0 ) STRPTR *names,
+	_REG( d0 ) LONG count,
+	_REG( d1 ) OpenModes mode,
+	_REG( d2 ) LONG bufferSize,
+	_REG( a1 ) struct ExecBase *SysBase,
+	_REG( a2 ) struct DosLibrary *DOSBase )
+#else
+_LIBCALL struct AsyncBatch *
+OpenAsyncBatch(
+	_REG( a0 ) STRPTR *names,
+	_REG( d0 ) LONG count,
+	_REG( d1 ) OpenModes mode,
+	_REG( d2 ) LONG bufferSize )
+#endif
+{
+#ifdef ASIO_NOEXTERNALS
+	return( NewBatch( names, count, NULL, mode, bufferSize, SysBase, DOSBase ) );
+#else
+	return( NewBatch( names, count, NULL, mode, bufferSize ) );
+#endif
+}
+
+
+_LIBCALL struct AsyncBatch *
+OpenAsyncDirBatch( _REG( a0 ) struct AsyncDir *dir, _REG( d0 ) OpenModes mode, _REG( d1 ) LONG bufferSize )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = dir->ad_SysBase;
+	struct DosLibrary	*DOSBase = dir->ad_DOSBase;
+
+	return( NewBatch( NULL, 0, dir, mode, bufferSize, SysBase, DOSBase ) );
+#else
+	return( NewBatch( NULL, 0, dir, mode, bufferSize ) );
+#endif
+}
+
+
+_LIBCALL LONG
+NextAsyncBatch( _REG( a0 ) struct AsyncBatch *batch, _REG( a1 ) AsyncFile **file )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = batch->ab_SysBase;
+	struct DosLibrary	*DOSBase = batch->ab_DOSBase;
+#endif
+	struct AsyncOpening	*opening;
+	LONG			index = batch->ab_Next;
+
+	*file = NULL;
+
+	/* the files are started ahead as long as there are more */
+	if( index >= batch->ab_Sent )
+	{
+		if( batch->ab_Dir )
+		{
+			SetIoErr( batch->ab_Dir->ad_Error );
+		}
+
+		return( -1 );
+	}
+
+	opening = &batch->ab_Opening[ index % BATCH_AHEAD ];
+
+	/* files further on may be ready before this one */
+	CollectOpens( batch, FALSE );
+
+	while( opening->ao_Pending )
+	{
+		CollectOpens( batch, TRUE );
+	}
+
+	*file = opening->ao_File;
+	opening->ao_File = NULL;
+
+	if( batch->ab_Dir )
+	{
+		UBYTE	*bstr = ( UBYTE * ) opening->ao_Name;
+
+		CopyMem( bstr + 1, batch->ab_Name, bstr[ 0 ] + 1 );
+	}
+
+	/* the slot is free again, so start opening another file in it */
+	++batch->ab_Next;
+	StartNext( batch );
+
+	SetIoErr( opening->ao_Error );
+	return( index );
+}
+
+
+_CALL STRPTR
+NameAsyncBatch( _REG( a0 ) struct AsyncBatch *batch )
+{
+	if( !batch->ab_Next )
+	{
+		return( NULL );
+	}
+
+	return( batch->ab_Dir ? batch->ab_Name : batch->ab_Names[ batch->ab_Next - 1 ] );
+}
+
+
+_LIBCALL VOID
+EndAsyncBatch( _REG( a0 ) struct AsyncBatch *batch )
+{
+	if( batch )
+	{
+#ifdef ASIO_NOEXTERNALS
+		struct ExecBase		*SysBase = batch->ab_SysBase;
+#endif
+		struct AsyncOpening	*opening;
+		LONG			i;
+
+		/* close the files that were opened ahead, but not handed out */
+		for( i = batch->ab_Next; i < batch->ab_Sent; ++i )
+		{
+			opening = &batch->ab_Opening[ i % BATCH_AHEAD ];
+
+			while( opening->ao_Pending )
+			{
+				CollectOpens( batch, TRUE );
+			}
+
+			if( opening->ao_File )
+			{
+				CloseAsync( opening->ao_File );
+			}
+		}
+
+		FreeVec( batch );
+	}
+}
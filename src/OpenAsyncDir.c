@@ -0,0 +1,260 @@
+#include "async.h"
+
+
+/* ask the file system for the next entries, in the buffer not being worked
+ * through
+ */
+static VOID
+SendExAll( struct AsyncDir *dir )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = dir->ad_SysBase;
+#endif
+
+	dir->ad_Packet.sp_Pkt.dp_Port	= &dir->ad_Port;
+	dir->ad_Packet.sp_Pkt.dp_Type	= ACTION_EXAMINE_ALL;
+	dir->ad_Packet.sp_Pkt.dp_Arg1	= dir->ad_Lock;
+	dir->ad_Packet.sp_Pkt.dp_Arg2	= ( LONG ) dir->ad_Buffers[ dir->ad_CurrentBuf ^ 1 ];
+	dir->ad_Packet.sp_Pkt.dp_Arg3	= dir->ad_BufferSize;
+	dir->ad_Packet.sp_Pkt.dp_Arg4	= dir->ad_Type;
+	dir->ad_Packet.sp_Pkt.dp_Arg5	= ( LONG ) dir->ad_Control;
+
+	PutMsg( ( ( struct FileLock * ) BADDR( dir->ad_Lock ) )->fl_Task, &dir->ad_Packet.sp_Msg );
+	dir->ad_PacketPending = TRUE;
+}
+
+
+/* wait for the packet sent by SendExAll() to come back */
+static VOID
+WaitExAll( struct AsyncDir *dir )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = dir->ad_SysBase;
+#endif
+
+	dir->ad_Port.mp_Flags = PA_SIGNAL;
+	WaitPort( &dir->ad_Port );
+	dir->ad_Port.mp_Flags = PA_IGNORE;
+	GetMsg( &dir->ad_Port );
+
+	dir->ad_PacketPending = FALSE;
+}
+
+
+/* switch to the other buffer, and send the packet for the entries after
+ * those in it. Returns FALSE if there are no more entries to be had.
+ */
+static BOOL
+NextBuffer( struct AsyncDir *dir )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct DosLibrary	*DOSBase = dir->ad_DOSBase;
+#endif
+	LONG	more = DOSFALSE;
+	LONG	error = 0;
+	LONG	entries;
+
+	if( dir->ad_Error )
+	{
+		return( FALSE );
+	}
+
+	if( dir->ad_PacketPending )
+	{
+		WaitExAll( dir );
+		more	= dir->ad_Packet.sp_Pkt.dp_Res1;
+		error	= dir->ad_Packet.sp_Pkt.dp_Res2;
+
+		/* older file systems don't know the packet, but dos.library
+		 * can do the same for them with Examine() and ExNext()
+		 */
+		if( !more && ( error == ERROR_ACTION_NOT_KNOWN ) )
+		{
+			dir->ad_Emulate = TRUE;
+		}
+	}
+
+	dir->ad_CurrentBuf ^= 1;
+
+	if( dir->ad_Emulate )
+	{
+		more	= ExAll( dir->ad_Lock, dir->ad_Buffers[ dir->ad_CurrentBuf ], dir->ad_BufferSize, dir->ad_Type, dir->ad_Control );
+		error	= IoErr();
+	}
+
+	/* the next packet reuses the control, so its count must be kept */
+	entries = dir->ad_Control->eac_Entries;
+
+	if( more )
+	{
+		/* read the next entries while the caller works through these */
+		if( !dir->ad_Emulate )
+		{
+			SendExAll( dir );
+		}
+	}
+	else
+	{
+		dir->ad_Error = error ? error : ERROR_NO_MORE_ENTRIES;
+	}
+
+	/* the last entries come with ERROR_NO_MORE_ENTRIES */
+	if( entries && ( more || ( error == ERROR_NO_MORE_ENTRIES ) ) )
+	{
+		dir->ad_Next = dir->ad_Buffers[ dir->ad_CurrentBuf ];
+	}
+
+	return( TRUE );
+}
+
+
+#ifdef ASIO_NOEXTERNALS
+_LIBCALL struct AsyncDir *
+OpenAsyncDir(
+	_REG( a0 ) STRPTR name,
+	_REG( d0 ) LONG type,
+	_REG( d1 ) LONG bufferSize,
+	_REG( a1 ) struct ExecBase *SysBase,
+	_REG( a2 ) struct DosLibrary *DOSBase )
+#else
+_LIBCALL struct AsyncDir *
+OpenAsyncDir( _REG( a0 ) STRPTR name, _REG( d0 ) LONG type, _REG( d1 ) LONG bufferSize )
+#endif
+{
+	struct AsyncDir	*dir;
+	LONG		size;
+
+	if( ( type < ED_NAME ) || ( type > ED_OWNER ) )
+	{
+		SetIoErr( ERROR_BAD_NUMBER );
+		return( NULL );
+	}
+
+	/* each buffer must have room for a few entries */
+	if( bufferSize < 1024 )
+	{
+		bufferSize = 1024;
+	}
+
+	size = ( bufferSize / 2 ) & ~3;
+
+	if( !( dir = AllocVec( ( ( sizeof( struct AsyncDir ) + 3 ) & ~3 ) + size * 2, MEMF_PUBLIC | MEMF_CLEAR ) ) )
+	{
+		SetIoErr( ERROR_NO_FREE_STORE );
+		return( NULL );
+	}
+
+	if( !( dir->ad_Control = AllocDosObject( DOS_EXALLCONTROL, NULL ) ) )
+	{
+		FreeVec( dir );
+		SetIoErr( ERROR_NO_FREE_STORE );
+		return( NULL );
+	}
+
+	if( !( dir->ad_Lock = Lock( name, SHARED_LOCK ) ) )
+	{
+		FreeDosObject( DOS_EXALLCONTROL, dir->ad_Control );
+		FreeVec( dir );
+		return( NULL );
+	}
+
+	dir->ad_Buffers[ 0 ]	= ( struct ExAllData * ) ( ( ( ULONG ) ( dir + 1 ) + 3 ) & ~3 );
+	dir->ad_Buffers[ 1 ]	= ( struct ExAllData * ) ( ( UBYTE * ) dir->ad_Buffers[ 0 ] + size );
+	dir->ad_BufferSize	= size;
+	dir->ad_Type		= type;
+	dir->ad_CurrentBuf	= 1;
+#ifdef ASIO_NOEXTERNALS
+	dir->ad_SysBase		= SysBase;
+	dir->ad_DOSBase		= DOSBase;
+#endif
+
+	/* the replies come back to a port set up like the one in AsyncFile */
+	dir->ad_Port.mp_MsgList.lh_Head		= ( struct Node * ) &dir->ad_Port.mp_MsgList.lh_Tail;
+	dir->ad_Port.mp_MsgList.lh_Tail		= NULL;
+	dir->ad_Port.mp_MsgList.lh_TailPred	= ( struct Node * ) &dir->ad_Port.mp_MsgList.lh_Head;
+	dir->ad_Port.mp_Node.ln_Type		= NT_MSGPORT;
+	dir->ad_Port.mp_Flags			= PA_IGNORE;
+	dir->ad_Port.mp_SigBit			= SIGB_SINGLE;
+	dir->ad_Port.mp_SigTask			= FindTask( NULL );
+
+	dir->ad_Packet.sp_Pkt.dp_Link			= &dir->ad_Packet.sp_Msg;
+	dir->ad_Packet.sp_Msg.mn_Node.ln_Name		= ( STRPTR ) &dir->ad_Packet.sp_Pkt;
+	dir->ad_Packet.sp_Msg.mn_Node.ln_Type		= NT_MESSAGE;
+	dir->ad_Packet.sp_Msg.mn_Length			= sizeof( struct StandardPacket );
+
+	/* like OpenAsync() in read mode, get the first entries coming in
+	 * while the caller gets ready
+	 */
+	SendExAll( dir );
+
+	return( dir );
+}
+
+
+_LIBCALL struct ExAllData *
+ReadAsyncDir( _REG( a0 ) struct AsyncDir *dir )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct DosLibrary	*DOSBase = dir->ad_DOSBase;
+#endif
+	struct ExAllData	*entry;
+
+	while( !dir->ad_Next )
+	{
+		if( !NextBuffer( dir ) )
+		{
+			SetIoErr( dir->ad_Error );
+			return( NULL );
+		}
+	}
+
+	entry		= dir->ad_Next;
+	dir->ad_Next	= entry->ed_Next;
+
+	return( entry );
+}
+
+
+_LIBCALL VOID
+CloseAsyncDir( _REG( a0 ) struct AsyncDir *dir )
+{
+	if( dir )
+	{
+#ifdef ASIO_NOEXTERNALS
+		struct ExecBase		*SysBase = dir->ad_SysBase;
+		struct DosLibrary	*DOSBase = dir->ad_DOSBase;
+#endif
+		if( dir->ad_PacketPending )
+		{
+			WaitExAll( dir );
+
+			if( !dir->ad_Packet.sp_Pkt.dp_Res1 )
+			{
+				dir->ad_Error = dir->ad_Packet.sp_Pkt.dp_Res2;
+			}
+		}
+
+		/* if the directory wasn't read to the end, the file system must be
+		 * told that we're done with it
+		 */
+		if( !dir->ad_Error )
+		{
+			if( dir->ad_Emulate )
+			{
+				while( ExAll( dir->ad_Lock, dir->ad_Buffers[ 0 ], dir->ad_BufferSize, dir->ad_Type, dir->ad_Control ) )
+				{
+				}
+			}
+			else
+			{
+				dir->ad_Packet.sp_Pkt.dp_Type = ACTION_EXAMINE_ALL_END;
+				PutMsg( ( ( struct FileLock * ) BADDR( dir->ad_Lock ) )->fl_Task, &dir->ad_Packet.sp_Msg );
+				WaitExAll( dir );
+			}
+		}
+
+		UnLock( dir->ad_Lock );
+		FreeDosObject( DOS_EXALLCONTROL, dir->ad_Control );
+		FreeVec( dir );
+	}
+}
@@ -17,13 +17,55 @@ AS_OpenAsyncFH( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt )
 {
 	struct FileHandle	*fh;
 	AsyncFile		*file = NULL;
+	struct AsyncPack	*pack = NULL;
 	BPTR	lock = NULL;
 	LONG	blockSize, blockSize2;
+	LONG	cached = 0;
+	LONG	align;
+	ULONG	modeFlags = ( ULONG ) mode & ~0xff;
 	D_S( struct InfoData, infoData );
 
+	if( mode & MODEF_COMPRESSED )
+	{
+		/* the compressed data goes through a file of its own, which
+		 * also takes care of closing the handle
+		 */
+#ifdef ASIO_NOEXTERNALS
+		if( !( pack = AS_OpenPack( handle, ( OpenModes ) ( mode & ~MODEF_COMPRESSED ), bufferSize, closeIt, SysBase, DOSBase ) ) )
+#else
+		if( !( pack = AS_OpenPack( handle, ( OpenModes ) ( mode & ~MODEF_COMPRESSED ), bufferSize, closeIt ) ) )
+#endif
+		{
+			return( NULL );
+		}
+
+		closeIt = FALSE;
+
+		/* each buffer must have room for a whole block */
+		if( bufferSize < PACK_BLOCKSIZE * 2 )
+		{
+			bufferSize = PACK_BLOCKSIZE * 2;
+		}
+	}
+
+	mode = OPEN_MODE( mode );
+
+	/* if another file was opened on the same volume before, we already know
+	 * its block size, and can do without the lock and Info() below
+	 */
+	if( handle )
+	{
+		fh = BADDR( handle );
+#ifdef ASIO_NOEXTERNALS
+		cached = AS_CachedBlockSize( fh->fh_Type, SysBase, DOSBase );
+#else
+		cached = AS_CachedBlockSize( fh->fh_Type );
+#endif
+	}
+
 	if( mode == MODE_READ )
 	{
-		if( handle )
+		if( handle && !cached )
 		{
 			lock = DupLockFromFH( handle );
 		}
@@ -34,10 +76,11 @@ AS_OpenAsyncFH( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt )
 		{
 			/* in append mode, we open for writing, and then seek to the
 			 * end of the file. That way, the initial write will happen at
-			 * the end of the file, thus extending it
+			 * the end of the file, thus extending it. For a compressed
+			 * file, the packed file has done that already.
 			 */
 
-			if( handle )
+			if( handle && !pack )
 			{
 				if( Seek( handle, 0, OFFSET_END ) < 0 )
 				{
@@ -55,7 +98,7 @@ AS_OpenAsyncFH( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt )
 		 * use DupLockFromFH() for a write-mode file though. So we get sneaky
 		 * and get a lock on the parent of the file
 		 */
-		if( handle )
+		if( handle && !cached )
 		{
 			lock = ParentOfFH( handle );
 		}
@@ -72,32 +115,55 @@ AS_OpenAsyncFH( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt )
 		blockSize = 512;
 		blockSize2 = 1024;
 
-		if( lock )
+		if( cached )
+		{
+			blockSize = cached;
+			blockSize2 = blockSize * 2;
+			bufferSize = ( ( bufferSize + blockSize2 - 1 ) / blockSize2 ) * blockSize2;
+		}
+		else if( lock )
 		{
 			if( Info( lock, infoData ) )
 			{
 				blockSize = infoData->id_BytesPerBlock;
 				blockSize2 = blockSize * 2;
 				bufferSize = ( ( bufferSize + blockSize2 - 1 ) / blockSize2 ) * blockSize2;
+
+#ifdef ASIO_NOEXTERNALS
+				AS_CacheBlockSize( fh->fh_Type, blockSize, SysBase, DOSBase );
+#else
+				AS_CacheBlockSize( fh->fh_Type, blockSize );
+#endif
 			}
 
 			UnLock(lock);
 		}
 
+		/* a direct file has its buffers aligned on the device blocks
+		 * (if the block size is a power of two), others on 16 bytes
+		 */
+		align = 16;
+
+		if( ( modeFlags & MODEF_DIRECT ) && ( blockSize > align ) && !( blockSize & ( blockSize - 1 ) ) )
+		{
+			align = blockSize;
+		}
+
 		/* now allocate the ASyncFile structure, as well as the read buffers.
-		 * Add 15 bytes to the total size in order to allow for later
-		 * quad-longword alignement of the buffers
+		 * Add align - 1 bytes to the total size in order to allow for later
+		 * alignement of the buffers
 		 */
 
 		for( ;; )
 		{
-			if( file = AllocVec( sizeof( AsyncFile ) + bufferSize + 15, MEMF_PUBLIC | MEMF_ANY ) )
+			if( file = AllocVec( sizeof( AsyncFile ) + bufferSize + align - 1, MEMF_PUBLIC | MEMF_ANY ) )
 			{
 				break;
 			}
 			else
 			{
-				if( bufferSize > blockSize2 )
+				if( ( bufferSize > blockSize2 ) &&
+					( !pack || ( bufferSize - blockSize2 >= PACK_BLOCKSIZE * 2 ) ) )
 				{
 					bufferSize -= blockSize2;
 				}
@@ -125,18 +191,31 @@ AS_OpenAsyncFH( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt )
 			 * some magic to avoid the cache problem. This magic will generally
 			 * involve flushing the CPU caches. This is very costly on an 040.
 			 * Aligning things avoids the need for magic, at the cost of at
-			 * most 15 bytes of ram.
+			 * most align - 1 bytes of ram.
 			 */
 
 			fh			= BADDR( file->af_File );
 			file->af_Handler	= fh->fh_Type;
 			file->af_BufferSize	= ( ULONG ) bufferSize / 2;
-			file->af_Buffers[ 0 ]	= ( APTR ) ( ( ( ULONG ) file + sizeof( AsyncFile ) + 15 ) & 0xfffffff0 );
+			file->af_Buffers[ 0 ]	= ( APTR ) ( ( ( ULONG ) file + sizeof( AsyncFile ) + align - 1 ) & ~( align - 1 ) );
 			file->af_Buffers[ 1 ]	= file->af_Buffers[ 0 ] + file->af_BufferSize;
 			file->af_CurrentBuf	= 0;
 			file->af_SeekOffset	= 0;
 			file->af_PacketPending	= FALSE;
 			file->af_SeekPastEOF	= FALSE;
+			file->af_BitBuffer	= 0;
+			file->af_BitCount	= 0;
+			file->af_Tees		= NULL;
+			file->af_DigestType	= DIGEST_NONE;
+			file->af_Packed		= pack;
+			file->af_ModeFlags	= modeFlags;
+			file->af_Group		= NULL;
+			file->af_NextInGroup	= NULL;
+			file->af_Scheduler	= NULL;
+			file->af_NextScheduled	= NULL;
+			file->af_Ticket		= 0;
+			file->af_Priority	= ASYNCPRI_NORMAL;
+			file->af_MaxRate	= 0;
 #ifdef ASIO_NOEXTERNALS
 			file->af_SysBase	= SysBase;
 			file->af_DOSBase	= DOSBase;
@@ -202,6 +281,20 @@ AS_OpenAsyncFH( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt )
 				file->af_Packet.sp_Pkt.dp_Type	= ACTION_WRITE;
 				file->af_BytesLeft		= file->af_BufferSize;
 				file->af_Offset			= file->af_Buffers[ 0 ];
+
+				/* a direct file that doesn't start on a block, e.g. in
+				 * append mode, only fills the first buffer up to the next
+				 * block, like after a SeekAsync()
+				 */
+				if( ( modeFlags & MODEF_DIRECT ) && !pack )
+				{
+					LONG	pos = Seek( handle, 0, OFFSET_CURRENT );
+
+					if( pos > 0 )
+					{
+						AS_AlignWrite( file, pos );
+					}
+				}
 			}
 		}
 		else
@@ -210,6 +303,11 @@ AS_OpenAsyncFH( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt )
 			{
 				Close( handle );
 			}
+
+			if( pack )
+			{
+				AS_ClosePack( pack );
+			}
 		}
 	}
 
@@ -16,6 +16,11 @@ ReadAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG n
 
 	while( numBytes > file->af_BytesLeft )
 	{
+		if( file->af_DigestType )
+		{
+			AS_UpdateDigest( file, file->af_Offset + file->af_BytesLeft );
+		}
+
 		/* drain buffer */
 		CopyMem( file->af_Offset, buffer, file->af_BytesLeft );
 
@@ -49,6 +54,7 @@ ReadAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG n
 		file->af_CurrentBuf	= 1 - file->af_CurrentBuf;
 		file->af_BytesLeft	= bytesArrived - file->af_SeekOffset;
 		file->af_SeekOffset	= 0;
+		file->af_DigestMark	= file->af_Offset;
 	}
 
 	CopyMem( file->af_Offset, buffer, numBytes );
@@ -0,0 +1,127 @@
+#include "async.h"
+
+
+/* bit functions handle at most this many bits at a time, so that a value
+ * can never be mistaken for -1
+ */
+#define MAX_BITS	24
+
+
+_LIBCALL LONG
+PeekBitsAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG numBits )
+{
+	ULONG	bits = file->af_BitBuffer;
+	LONG	count = file->af_BitCount;
+	UBYTE	*p;
+	LONG	left;
+
+	if( ( numBits <= 0 ) || ( numBits > MAX_BITS ) )
+	{
+		return( -1 );
+	}
+
+	while( count < numBits )
+	{
+		if( ( left = AS_FillBuffer( file ) ) < 0 )
+		{
+			return( -1 );
+		}
+
+		if( !left )
+		{
+			if( !count )
+			{
+				return( -1 );
+			}
+
+			/* pretend the file is padded with zero bits */
+			bits	<<= numBits - count;
+			count	= numBits;
+			break;
+		}
+
+		p = file->af_Offset;
+
+		/* look at the next few bytes without consuming them */
+		while( ( count < numBits ) && left )
+		{
+			bits	= ( bits << 8 ) | *p++;
+			count	+= 8;
+			--left;
+		}
+
+		if( count < numBits )
+		{
+			/* the bits we need continue in the next buffer, so we
+			 * have to take these bytes out of this one before we can
+			 * get to it
+			 */
+
+			file->af_BitBuffer	= bits;
+			file->af_BitCount	= count;
+			file->af_BytesLeft	= 0;
+			file->af_Offset		= p;
+		}
+	}
+
+	return( ( LONG ) ( ( bits >> ( count - numBits ) ) & ( ( 1UL << numBits ) - 1 ) ) );
+}
+
+
+_LIBCALL LONG
+ReadBitsAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG numBits )
+{
+	ULONG	bits = file->af_BitBuffer;
+	LONG	count = file->af_BitCount;
+	LONG	left;
+
+	if( ( numBits <= 0 ) || ( numBits > MAX_BITS ) )
+	{
+		return( -1 );
+	}
+
+	while( count < numBits )
+	{
+		/* only take the bytes we actually need, so that the byte
+		 * functions can carry on after AlignBitsAsync()
+		 */
+
+		if( ( left = AS_FillBuffer( file ) ) < 0 )
+		{
+			file->af_BitBuffer	= bits;
+			file->af_BitCount	= count;
+			return( -1 );
+		}
+
+		if( !left )
+		{
+			if( !count )
+			{
+				file->af_BitBuffer = 0;
+				return( -1 );
+			}
+
+			/* like PeekBitsAsync(), pretend the file is padded with
+			 * zero bits
+			 */
+			bits	<<= numBits - count;
+			count	= numBits;
+			break;
+		}
+
+		while( ( count < numBits ) && left )
+		{
+			bits	= ( bits << 8 ) | *file->af_Offset++;
+			count	+= 8;
+			--left;
+		}
+
+		file->af_BytesLeft = left;
+	}
+
+	count			-= numBits;
+	file->af_BitCount	= count;
+	file->af_BitBuffer	= bits & ( ( 1UL << count ) - 1 );
+
+	return( ( LONG ) ( ( bits >> count ) & ( ( 1UL << numBits ) - 1 ) ) );
+}
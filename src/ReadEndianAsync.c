@@ -0,0 +1,66 @@
+#include "async.h"
+
+
+_LIBCALL LONG
+ReadEndianAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG count, _REG( d1 ) ULONG format )
+{
+	UBYTE	*to = buffer;
+	LONG	size = format & AEF_SIZEMASK;
+	LONG	numRead = 0;
+	LONG	num;
+
+	/* elements are 1, 2, 4 or 8 bytes */
+	if( ( size != 1 ) && ( size != 2 ) && ( size != 4 ) && ( size != 8 ) )
+	{
+#ifdef ASIO_NOEXTERNALS
+		struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+
+		SetIoErr( ERROR_BAD_NUMBER );
+		return( -1 );
+	}
+
+	while( count > 0 )
+	{
+		if( ( num = file->af_BytesLeft / size ) != 0 )
+		{
+			/* convert as many elements as there are in the current
+			 * buffer
+			 */
+
+			num = MIN( num, count );
+			AS_CopyEndian( file, file->af_Offset, to, num, format );
+			file->af_BytesLeft	-= num * size;
+			file->af_Offset		+= num * size;
+		}
+		else
+		{
+			UBYTE	tmp[ AEF_SIZEMASK ];
+			LONG	bytes;
+
+			/* the element is split over two buffers (or the buffer is
+			 * empty), so let ReadAsync() put it together
+			 */
+
+			if( ( bytes = ReadAsync( file, tmp, size ) ) < size )
+			{
+				if( bytes < 0 )
+				{
+					return( -1 );
+				}
+
+				/* EOF, possibly in the middle of an element */
+				break;
+			}
+
+			num = 1;
+			AS_CopyEndian( file, tmp, to, 1, format );
+		}
+
+		to		+= num * size;
+		count		-= num;
+		numRead		+= num;
+	}
+
+	return( numRead );
+}
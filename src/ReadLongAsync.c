@@ -0,0 +1,190 @@
+#include "async.h"
+
+
+/* ReadNumber() result for text that isn't a number */
+#define BAD_NUMBER	( -2 )
+
+/* characters that may appear between two numbers */
+#define IS_SEPARATOR(c) ( ( c ) == ' ' || ( c ) == ',' || ( c ) == '\n' || \
+			  ( c ) == '\t' || ( c ) == '\r' || ( c ) == '\f' || ( c ) == '\v' )
+
+
+/* Convert four ASCII digits at p in one go. The bytes are fetched one
+ * at a time, so p need not be aligned (the 68000 would not like that).
+ * Returns -1 if any of the four bytes isn't a digit.
+ */
+static LONG
+Digits4( UBYTE *p )
+{
+	ULONG	chunk;
+
+	chunk = ( ( ULONG ) p[ 0 ] << 24 ) | ( ( ULONG ) p[ 1 ] << 16 ) |
+		( ( ULONG ) p[ 2 ] << 8 ) | p[ 3 ];
+
+	/* all four bytes must be in the range 0x30-0x39. Adding 6 to each
+	 * pushes 0x3a-0x3f into the next row, without carrying into the
+	 * neighbour byte.
+	 */
+	if( ( ( chunk & 0xf0f0f0f0 ) ^ 0x30303030 ) |
+		( ( ( chunk + 0x06060606 ) & 0xf0f0f0f0 ) ^ 0x30303030 ) )
+	{
+		return( -1 );
+	}
+
+	chunk -= 0x30303030;
+
+	/* combine neighbouring digits into two 16 bit lanes, then the lanes.
+	 * Multiplications are written as shifts, as a long multiply is a
+	 * library call on the 68000.
+	 */
+	chunk = ( ( ( chunk >> 8 ) & 0x000f000f ) << 3 ) + ( ( ( chunk >> 8 ) & 0x000f000f ) << 1 ) +
+		( chunk & 0x000f000f );
+
+	return( ( LONG ) ( ( ( chunk >> 16 ) << 6 ) + ( ( chunk >> 16 ) << 5 ) + ( ( chunk >> 16 ) << 2 ) +
+		( chunk & 0xffff ) ) );
+}
+
+
+/* parse one number. Returns 1 if a number was read, 0 at EOF, -1 on error
+ * and BAD_NUMBER if the text didn't make sense.
+ */
+static LONG
+ReadNumber( AsyncFile *file, LONG *value )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+	UBYTE	*p;
+	LONG	left;
+	LONG	digit;
+	ULONG	acc = 0;
+	LONG	digits = 0;
+	BOOL	negative = FALSE;
+
+	/* skip separators, which may well span several buffers */
+	for( ;; )
+	{
+		if( ( left = AS_FillBuffer( file ) ) <= 0 )
+		{
+			return( left );
+		}
+
+		p = file->af_Offset;
+
+		while( left && IS_SEPARATOR( *p ) )
+		{
+			++p;
+			--left;
+		}
+
+		file->af_Offset		= p;
+		file->af_BytesLeft	= left;
+
+		if( left )
+		{
+			break;
+		}
+	}
+
+	if( ( *p == '-' ) || ( *p == '+' ) )
+	{
+		negative = ( *p == '-' );
+		++file->af_Offset;
+		--file->af_BytesLeft;
+	}
+
+	for( ;; )
+	{
+		if( ( left = AS_FillBuffer( file ) ) < 0 )
+		{
+			return( -1 );
+		}
+
+		if( !left )
+		{
+			/* EOF ends the number */
+			break;
+		}
+
+		p = file->af_Offset;
+
+		/* four digits at a time while there's no risk of overflow */
+		while( ( left >= 4 ) && ( digits <= 5 ) && ( ( digit = Digits4( p ) ) >= 0 ) )
+		{
+			acc = acc * 10000 + digit;
+			digits += 4;
+			p += 4;
+			left -= 4;
+		}
+
+		while( left && ( ( digit = *p - '0' ) >= 0 ) && ( digit <= 9 ) )
+		{
+			if( ( acc > 214748364 ) || ( ( acc == 214748364 ) && ( digit > 7 + negative ) ) )
+			{
+				file->af_Offset		= p;
+				file->af_BytesLeft	= left;
+				SetIoErr( ERROR_BAD_NUMBER );
+				return( BAD_NUMBER );
+			}
+
+			acc = acc * 10 + digit;
+			++digits;
+			++p;
+			--left;
+		}
+
+		file->af_Offset		= p;
+		file->af_BytesLeft	= left;
+
+		if( left )
+		{
+			/* stopped at something that isn't a digit */
+			break;
+		}
+	}
+
+	if( !digits )
+	{
+		SetIoErr( ERROR_BAD_NUMBER );
+		return( BAD_NUMBER );
+	}
+
+	*value = negative ? ( LONG ) ( 0 - acc ) : ( LONG ) acc;
+	return( 1 );
+}
+
+
+_LIBCALL LONG
+ReadLongsAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) LONG *array, _REG( d0 ) LONG count )
+{
+	LONG	numRead = 0;
+	LONG	result;
+
+	while( numRead < count )
+	{
+		if( ( result = ReadNumber( file, &array[ numRead ] ) ) <= 0 )
+		{
+			/* Don't throw away what we already have if we hit
+			 * something that isn't a number. The offending character
+			 * is left unread.
+			 */
+			if( ( result == -1 ) || ( ( result == BAD_NUMBER ) && !numRead ) )
+			{
+				return( -1 );
+			}
+
+			break;
+		}
+
+		++numRead;
+	}
+
+	return( numRead );
+}
+
+
+_CALL LONG
+ReadLongAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) LONG *value )
+{
+	return( ReadLongsAsync( file, value, 1 ) );
+}
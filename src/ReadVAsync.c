@@ -0,0 +1,48 @@
+#include "async.h"
+
+
+_LIBCALL LONG
+ReadVAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) struct AsyncIOVec *vec, _REG( d0 ) LONG count )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = file->af_SysBase;
+#endif
+	LONG totalBytes = 0;
+	LONG bytes;
+
+	for( ; count > 0; --count, ++vec )
+	{
+		if( vec->iov_Len <= file->af_BytesLeft )
+		{
+			/* the whole element is in the current buffer, so take it
+			 * directly, without going through the main read loop
+			 */
+
+			CopyMem( file->af_Offset, vec->iov_Base, vec->iov_Len );
+			file->af_BytesLeft	-= vec->iov_Len;
+			file->af_Offset		+= vec->iov_Len;
+			totalBytes		+= vec->iov_Len;
+		}
+		else
+		{
+			/* the element spans a buffer flip, let ReadAsync() drain
+			 * the current buffer and wait for the next one
+			 */
+
+			if( ( bytes = ReadAsync( file, vec->iov_Base, vec->iov_Len ) ) < 0 )
+			{
+				return( -1 );
+			}
+
+			totalBytes += bytes;
+
+			if( bytes < vec->iov_Len )
+			{
+				/* EOF */
+				break;
+			}
+		}
+	}
+
+	return( totalBytes );
+}
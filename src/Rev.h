@@ -1,9 +1,9 @@
-#define VERSION "39.3"
-#define DATE "31.7.2025"
-#define DAY 31
-#define MONTH 7
-#define YEAR 2025
-#define VERNUM 39
-#define REVNUM 3
+#define VERSION "40.0"
+#define DATE "18.10.2026"
+#define DAY 18
+#define MONTH 10
+#define YEAR 2026
+#define VERNUM 40
+#define REVNUM 0
 #define SUBREVNUM 0
-#define DATESTAMP { 7252, 639, 299 }
+#define DATESTAMP { 17822, 639, 299 }
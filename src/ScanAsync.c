@@ -0,0 +1,256 @@
+#include "async.h"
+
+
+/* the range has been read, so its file isn't needed any more */
+static VOID
+EndRange( struct AsyncRange *range )
+{
+	if( range->ar_File )
+	{
+		AttachAsync( range->ar_File, NULL );
+		CloseAsync( range->ar_File );
+		range->ar_File = NULL;
+	}
+
+	range->ar_Left = 0;
+}
+
+
+/* move file to the start of the first record at or after position, that is
+ * just past the next separator from position - 1 on. Returns the start, or
+ * -1 if the file couldn't be read.
+ */
+static LONG
+FindStart( AsyncFile *file, LONG position, LONG size, LONG separator )
+{
+	LONG	ch;
+
+	if( ( separator < 0 ) || !position )
+	{
+		return( ( SeekAsync( file, position, MODE_START ) < 0 ) ? -1 : position );
+	}
+
+	if( SeekAsync( file, position - 1, MODE_START ) < 0 )
+	{
+		return( -1 );
+	}
+
+	--position;
+
+	while( position < size )
+	{
+		if( ( ch = ReadCharAsync( file ) ) < 0 )
+		{
+			return( -1 );
+		}
+
+		++position;
+
+		if( ch == separator )
+		{
+			break;
+		}
+	}
+
+	return( position );
+}
+
+
+#ifdef ASIO_NOEXTERNALS
+_LIBCALL struct AsyncScan *
+OpenAsyncScan(
+	_REG( a0 ) STRPTR name,
+	_REG( d0 ) LONG ranges,
+	_REG( d1 ) LONG separator,
+	_REG( d2 ) LONG bufferSize,
+	_REG( a1 ) struct ExecBase *SysBase,
+	_REG( a2 ) struct DosLibrary *DOSBase )
+#else
+_LIBCALL struct AsyncScan *
+OpenAsyncScan(
+	_REG( a0 ) STRPTR name,
+	_REG( d0 ) LONG ranges,
+	_REG( d1 ) LONG separator,
+	_REG( d2 ) LONG bufferSize )
+#endif
+{
+	D_S( struct FileInfoBlock, fib );
+	struct AsyncScan	*scan;
+	struct AsyncRange	*range;
+	AsyncFile		*file;
+	LONG			size, start, next;
+	LONG			error = 0;
+	BOOL			failed = FALSE;
+	LONG			i;
+
+	if( ranges < 1 )
+	{
+		ranges = 1;
+	}
+
+	if( !( scan = AllocVec( sizeof( struct AsyncScan ) + ( ranges - 1 ) * sizeof( struct AsyncRange ), MEMF_PUBLIC | MEMF_CLEAR ) ) )
+	{
+		SetIoErr( ERROR_NO_FREE_STORE );
+		return( NULL );
+	}
+
+	scan->asc_Count		= ranges;
+#ifdef ASIO_NOEXTERNALS
+	scan->asc_SysBase	= SysBase;
+	scan->asc_DOSBase	= DOSBase;
+
+	if( !( scan->asc_Group = CreateAsyncGroup( SysBase ) ) )
+#else
+	if( !( scan->asc_Group = CreateAsyncGroup() ) )
+#endif
+	{
+		FreeVec( scan );
+		SetIoErr( ERROR_NO_FREE_STORE );
+		return( NULL );
+	}
+
+#ifdef ASIO_NOEXTERNALS
+	if( !( file = OpenAsync( name, MODE_READ, bufferSize, SysBase, DOSBase ) ) )
+#else
+	if( !( file = OpenAsync( name, MODE_READ, bufferSize ) ) )
+#endif
+	{
+		failed = TRUE;
+	}
+	else if( !ExamineFH( file->af_File, fib ) )
+	{
+		failed = TRUE;
+		error = IoErr();
+		CloseAsync( file );
+	}
+	else
+	{
+		scan->asc_Ranges[ 0 ].ar_File = file;
+
+		size	= fib->fib_Size;
+		start	= 0;
+
+		for( i = 1; i < scan->asc_Count; ++i )
+		{
+			/* each range starts with a record of its own, so a record
+			 * that goes past the even split belongs to the range before
+			 */
+			next	= ( size / scan->asc_Count ) * i + ( ( size % scan->asc_Count ) * i ) / scan->asc_Count;
+			next	= ( next < start ) ? start : next;
+			range	= &scan->asc_Ranges[ i ];
+
+#ifdef ASIO_NOEXTERNALS
+			if( !( range->ar_File = OpenAsync( name, MODE_READ, bufferSize, SysBase, DOSBase ) ) ||
+#else
+			if( !( range->ar_File = OpenAsync( name, MODE_READ, bufferSize ) ) ||
+#endif
+				( ( next = FindStart( range->ar_File, next, size, separator ) ) < 0 ) )
+			{
+				failed = TRUE;
+				break;
+			}
+
+			range[ -1 ].ar_Left	= next - start;
+			start			= next;
+		}
+
+		scan->asc_Ranges[ scan->asc_Count - 1 ].ar_Left = size - start;
+	}
+
+	if( failed )
+	{
+		/* closing the files mustn't lose the reason */
+		if( !error )
+		{
+			error = IoErr();
+		}
+
+		CloseAsyncScan( scan );
+		SetIoErr( error );
+		return( NULL );
+	}
+
+	/* all the ranges are read at once; those that are empty are done */
+	for( i = 0; i < scan->asc_Count; ++i )
+	{
+		range = &scan->asc_Ranges[ i ];
+
+		if( range->ar_Left )
+		{
+			AttachAsync( range->ar_File, scan->asc_Group );
+		}
+		else
+		{
+			EndRange( range );
+		}
+	}
+
+	return( scan );
+}
+
+
+_LIBCALL LONG
+ReadAsyncScan( _REG( a0 ) struct AsyncScan *scan, _REG( a1 ) APTR buffer, _REG( d0 ) LONG numBytes, _REG( a2 ) LONG *index )
+{
+	struct AsyncRange	*range;
+	AsyncFile		*file;
+	LONG			length, bytes;
+
+	*index = -1;
+
+	if( numBytes <= 0 )
+	{
+		return( 0 );
+	}
+
+	/* take the data of whichever range has some */
+	while( file = WaitAnyAsync( scan->asc_Group ) )
+	{
+		for( range = scan->asc_Ranges; range->ar_File != file; ++range )
+		{
+		}
+
+		length = MIN( numBytes, range->ar_Left );
+
+		if( ( bytes = TryReadAsync( file, buffer, length ) ) < 0 )
+		{
+			return( -1 );
+		}
+
+		range->ar_Left -= bytes;
+
+		if( !bytes || !range->ar_Left )
+		{
+			EndRange( range );
+		}
+
+		if( bytes )
+		{
+			*index = range - scan->asc_Ranges;
+			return( bytes );
+		}
+	}
+
+	return( 0 );
+}
+
+
+_LIBCALL VOID
+CloseAsyncScan( _REG( a0 ) struct AsyncScan *scan )
+{
+	if( scan )
+	{
+#ifdef ASIO_NOEXTERNALS
+		struct ExecBase	*SysBase = scan->asc_SysBase;
+#endif
+		LONG		i;
+
+		for( i = 0; i < scan->asc_Count; ++i )
+		{
+			EndRange( &scan->asc_Ranges[ i ] );
+		}
+
+		DeleteAsyncGroup( scan->asc_Group );
+		FreeVec( scan );
+	}
+}
@@ -0,0 +1,413 @@
+#include "async.h"
+
+
+/* Returns TRUE if the packet of file has come back to its port */
+static BOOL
+Arrived( AsyncFile *file )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = file->af_SysBase;
+#endif
+	struct Node	*node;
+	BOOL		arrived = FALSE;
+
+	Forbid();
+
+	for( node = file->af_PacketPort.mp_MsgList.lh_Head; node->ln_Succ; node = node->ln_Succ )
+	{
+		if( node == &file->af_Packet.sp_Msg.mn_Node )
+		{
+			arrived = TRUE;
+			break;
+		}
+	}
+
+	Permit();
+
+	return( arrived );
+}
+
+
+static struct AsyncQueue *
+FindQueue( struct AsyncScheduler *scheduler, struct MsgPort *handler )
+{
+	struct AsyncQueue	*queue;
+
+	for( queue = scheduler->as_Queues; queue; queue = queue->aq_Next )
+	{
+		if( queue->aq_Handler == handler )
+		{
+			break;
+		}
+	}
+
+	return( queue );
+}
+
+
+/* send the held packet of file to the device, giving it the turn if
+ * another file had it
+ */
+static VOID
+Dispatch( struct AsyncQueue *queue, AsyncFile *file )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = file->af_SysBase;
+#endif
+
+	if( queue->aq_Owner != file )
+	{
+		queue->aq_Owner		= file;
+		queue->aq_TurnLeft	= file->af_Scheduler->as_Turn;
+	}
+
+	--queue->aq_TurnLeft;
+	queue->aq_Busy	= file;
+	file->af_Ticket	= 0;
+
+	PutMsg( file->af_Handler, &file->af_Packet.sp_Msg );
+}
+
+
+/* if the device is free, send it the next packet. Of the packets held, the
+ * one of the file with the highest priority goes first, or among equals,
+ * the one that has been held the longest. The file whose turn it is still
+ * goes before files of the same or a lower priority. Until its turn is used
+ * up, the device is also kept for it while it works through the buffer
+ * that just came in, as it will most likely send its next packet soon.
+ */
+static VOID
+Update( struct AsyncScheduler *scheduler, struct AsyncQueue *queue )
+{
+	AsyncFile	*busy = queue->aq_Busy;
+	AsyncFile	*owner = queue->aq_Owner;
+	AsyncFile	*file, *next = NULL;
+
+	if( busy && ( busy->af_Ticket || !busy->af_PacketPending || Arrived( busy ) ) )
+	{
+		queue->aq_Busy = NULL;
+	}
+
+	if( queue->aq_Busy )
+	{
+		return;
+	}
+
+	for( file = scheduler->as_Files; file; file = file->af_NextScheduled )
+	{
+		if( file->af_Ticket && ( file->af_Handler == queue->aq_Handler ) &&
+			( !next || ( file->af_Priority > next->af_Priority ) ||
+			( ( file->af_Priority == next->af_Priority ) && ( ( LONG ) ( file->af_Ticket - next->af_Ticket ) < 0 ) ) ) )
+		{
+			next = file;
+		}
+	}
+
+	if( owner && ( queue->aq_TurnLeft > 0 ) && ( !next || ( owner->af_Priority >= next->af_Priority ) ) )
+	{
+		if( owner->af_Ticket )
+		{
+			next = owner;
+		}
+		else if( owner->af_PacketPending )
+		{
+			return;
+		}
+	}
+
+	if( !next )
+	{
+		return;
+	}
+
+	/* a file of a higher priority, still working through the buffer that
+	 * came in last, keeps the device from files of a lower priority
+	 */
+	for( file = scheduler->as_Files; file; file = file->af_NextScheduled )
+	{
+		if( ( file->af_Handler == queue->aq_Handler ) && ( file->af_Priority > next->af_Priority ) &&
+			file->af_PacketPending && !file->af_Ticket )
+		{
+			return;
+		}
+	}
+
+	Dispatch( queue, next );
+}
+
+
+/* hold the packet of a scheduled file until the device is free, and it is
+ * the file's turn. The packet has been set up by AS_SendPacket().
+ */
+VOID
+AS_QueuePacket( AsyncFile *file )
+{
+	struct AsyncScheduler	*scheduler = file->af_Scheduler;
+
+	file->af_Ticket = ++scheduler->as_Ticket;
+
+	/* zero means "not held" */
+	if( !file->af_Ticket )
+	{
+		file->af_Ticket = ++scheduler->as_Ticket;
+	}
+
+	Update( scheduler, FindQueue( scheduler, file->af_Handler ) );
+}
+
+
+/* the caller needs the held packet of file now. If wait is set, wait for
+ * the device to be free, otherwise only send the packet if it is free
+ * already.
+ */
+VOID
+AS_ReleasePacket( AsyncFile *file, BOOL wait )
+{
+	struct AsyncScheduler	*scheduler = file->af_Scheduler;
+	struct AsyncQueue	*queue = FindQueue( scheduler, file->af_Handler );
+	AsyncFile		*busy;
+
+	while( file->af_Ticket )
+	{
+		Update( scheduler, queue );
+
+		if( !file->af_Ticket )
+		{
+			break;
+		}
+
+		if( !( busy = queue->aq_Busy ) )
+		{
+			/* the file waiting comes before the one the device is
+			 * being kept for
+			 */
+			Dispatch( queue, file );
+			break;
+		}
+
+		if( !wait )
+		{
+			break;
+		}
+
+		/* the files of a scheduler belong to one task, so the port
+		 * of the busy file can be waited on, like in AS_WaitPacket()
+		 */
+		{
+#ifdef ASIO_NOEXTERNALS
+			struct ExecBase	*SysBase = busy->af_SysBase;
+#endif
+			busy->af_PacketPort.mp_Flags = PA_SIGNAL;
+
+			while( !Arrived( busy ) )
+			{
+				Wait( 1UL << busy->af_PacketPort.mp_SigBit );
+			}
+
+			busy->af_PacketPort.mp_Flags = IDLE_PORT_FLAGS( busy );
+		}
+	}
+}
+
+
+/* Returns the file that has the device while the packet of file is held,
+ * or NULL if the packet isn't held or waits for a turn only. That file's
+ * packet coming back may let the held one go out.
+ */
+AsyncFile *
+AS_BusyFile( AsyncFile *file )
+{
+	if( !file->af_Ticket )
+	{
+		return( NULL );
+	}
+
+	return( FindQueue( file->af_Scheduler, file->af_Handler )->aq_Busy );
+}
+
+
+/* take file out of its scheduler. A packet still held is sent at once. */
+static VOID
+Unschedule( AsyncFile *file )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = file->af_SysBase;
+#endif
+	struct AsyncScheduler	*scheduler = file->af_Scheduler;
+	struct AsyncQueue	*queue = FindQueue( scheduler, file->af_Handler );
+	AsyncFile		**link;
+
+	for( link = &scheduler->as_Files; *link; link = &( *link )->af_NextScheduled )
+	{
+		if( *link == file )
+		{
+			*link = file->af_NextScheduled;
+			break;
+		}
+	}
+
+	file->af_NextScheduled	= NULL;
+	file->af_Scheduler	= NULL;
+
+	if( file->af_Ticket )
+	{
+		file->af_Ticket = 0;
+		PutMsg( file->af_Handler, &file->af_Packet.sp_Msg );
+	}
+
+	if( queue->aq_Busy == file )
+	{
+		queue->aq_Busy = NULL;
+	}
+
+	if( queue->aq_Owner == file )
+	{
+		queue->aq_Owner = NULL;
+	}
+
+	/* the device may be free for the others now */
+	Update( scheduler, queue );
+}
+
+
+#ifdef ASIO_NOEXTERNALS
+_LIBCALL struct AsyncScheduler *
+CreateAsyncScheduler( _REG( d0 ) LONG turn, _REG( a0 ) struct ExecBase *SysBase )
+#else
+_LIBCALL struct AsyncScheduler *
+CreateAsyncScheduler( _REG( d0 ) LONG turn )
+#endif
+{
+	struct AsyncScheduler	*scheduler;
+
+	if( scheduler = AllocVec( sizeof( struct AsyncScheduler ), MEMF_PUBLIC | MEMF_CLEAR ) )
+	{
+		scheduler->as_Turn	= ( turn > 0 ) ? turn : 1;
+#ifdef ASIO_NOEXTERNALS
+		scheduler->as_SysBase	= SysBase;
+#endif
+	}
+
+	return( scheduler );
+}
+
+
+_LIBCALL VOID
+DeleteAsyncScheduler( _REG( a0 ) struct AsyncScheduler *scheduler )
+{
+	if( scheduler )
+	{
+#ifdef ASIO_NOEXTERNALS
+		struct ExecBase		*SysBase = scheduler->as_SysBase;
+#endif
+		struct AsyncQueue	*queue;
+
+		while( scheduler->as_Files )
+		{
+			Unschedule( scheduler->as_Files );
+		}
+
+		while( queue = scheduler->as_Queues )
+		{
+			scheduler->as_Queues = queue->aq_Next;
+			FreeVec( queue );
+		}
+
+		FreeVec( scheduler );
+	}
+}
+
+
+_LIBCALL BOOL
+ScheduleAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) struct AsyncScheduler *scheduler )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = file->af_SysBase;
+#endif
+	struct AsyncQueue	*queue;
+
+	/* waiting for another file's packet doesn't mix with a group */
+	if( scheduler && file->af_Group )
+	{
+		AttachAsync( file, NULL );
+	}
+
+	/* the packets of a compressed file are sent by the file it goes
+	 * through
+	 */
+	if( file->af_Packed )
+	{
+		return( ScheduleAsync( file->af_Packed->ap_File, scheduler ) );
+	}
+
+	if( file->af_Scheduler == scheduler )
+	{
+		return( TRUE );
+	}
+
+	if( file->af_Scheduler )
+	{
+		Unschedule( file );
+	}
+
+	/* NIL: doesn't get any packets */
+	if( !scheduler || !file->af_Handler )
+	{
+		return( TRUE );
+	}
+
+	if( !( queue = FindQueue( scheduler, file->af_Handler ) ) )
+	{
+		if( !( queue = AllocVec( sizeof( struct AsyncQueue ), MEMF_PUBLIC | MEMF_CLEAR ) ) )
+		{
+			return( FALSE );
+		}
+
+		queue->aq_Handler	= file->af_Handler;
+		queue->aq_Next		= scheduler->as_Queues;
+		scheduler->as_Queues	= queue;
+	}
+
+	file->af_Scheduler	= scheduler;
+	file->af_NextScheduled	= scheduler->as_Files;
+	scheduler->as_Files	= file;
+
+	/* a packet already out keeps the device busy */
+	if( file->af_PacketPending && !queue->aq_Busy && !Arrived( file ) )
+	{
+		queue->aq_Busy = file;
+	}
+
+	return( TRUE );
+}
+
+
+_LIBCALL VOID
+SetPriorityAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG priority, _REG( d1 ) LONG maxRate )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+
+	file->af_Priority	= priority;
+	file->af_MaxRate	= ( maxRate > 0 ) ? maxRate : 0;
+
+	/* the packets of a compressed file are sent by the file it goes
+	 * through
+	 */
+	if( file->af_Packed )
+	{
+		SetPriorityAsync( file->af_Packed->ap_File, priority, maxRate );
+		return;
+	}
+
+	/* the rate is counted from now on */
+	DateStamp( &file->af_RateBase );
+	file->af_RateNext = 0;
+
+	/* a held packet may go before others now */
+	if( file->af_Scheduler )
+	{
+		Update( file->af_Scheduler, FindQueue( file->af_Scheduler, file->af_Handler ) );
+	}
+}
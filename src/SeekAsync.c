@@ -20,6 +20,27 @@ GetFileSize( AsyncFile *file, LONG *size )
 }
 
 
+/* Start an empty write buffer for a direct file at position in the file.
+ * The data goes at the same offset into the buffer as position has into
+ * its block, and only the rest of the buffer is written, so that the
+ * buffer ends on a block, and all the writes after it are block-aligned.
+ */
+VOID
+AS_AlignWrite( AsyncFile *file, LONG position )
+{
+	ULONG	skip = ( ULONG ) position % file->af_BlockSize;
+
+	if( skip >= file->af_BufferSize )
+	{
+		skip = 0;
+	}
+
+	file->af_SeekOffset	= skip;
+	file->af_Offset		= file->af_Buffers[ file->af_CurrentBuf ] + skip;
+	file->af_BytesLeft	= file->af_BufferSize - skip;
+}
+
+
 _LIBCALL LONG
 SeekAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG position, _REG( d1 ) SeekModes mode )
 {
@@ -30,6 +51,35 @@ SeekAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG position, _REG( d1 ) Seek
 	LONG	minBuf, maxBuf, bytesArrived, diff;
 	LONG	fileSize;
 
+	/* there's no telling where a position ends up in a compressed file */
+	if( file->af_Packed )
+	{
+		SetIoErr( ERROR_ACTION_NOT_KNOWN );
+		return( -1 );
+	}
+
+	/* bits from the bit functions don't survive a seek. Partial bytes
+	 * being written are padded out first.
+	 */
+	if( file->af_BitCount )
+	{
+		if( !file->af_ReadMode )
+		{
+			AlignBitsAsync( file );
+		}
+
+		file->af_BitCount	= 0;
+		file->af_BitBuffer	= 0;
+	}
+
+	/* the digest only covers the bytes actually read or written, so
+	 * catch up before the position changes
+	 */
+	if( file->af_DigestType )
+	{
+		AS_UpdateDigest( file, file->af_Offset );
+	}
+
 	bytesArrived = AS_WaitPacket( file );
 
 	/* MH: No packets can be pending here! */
@@ -243,13 +293,24 @@ SeekAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG position, _REG( d1 ) Seek
 	}
 	else
 	{
-		/* flush the buffers */
-		if( file->af_BufferSize > file->af_BytesLeft )
+		/* flush the buffers. After an aligned seek, the data only starts
+		 * af_SeekOffset bytes into the buffer.
+		 */
+		if( file->af_BufferSize - file->af_SeekOffset > file->af_BytesLeft )
 		{
 			if( Write(
 				file->af_File,
-				file->af_Buffers[ file->af_CurrentBuf ],
-				file->af_BufferSize - file->af_BytesLeft ) < 0 )
+				file->af_Buffers[ file->af_CurrentBuf ] + file->af_SeekOffset,
+				file->af_BufferSize - file->af_SeekOffset - file->af_BytesLeft ) < 0 )
+			{
+				AS_RecordSyncFailure( file );
+				return( -1 );
+			}
+
+			if( !AS_WriteTees(
+				file,
+				file->af_Buffers[ file->af_CurrentBuf ] + file->af_SeekOffset,
+				file->af_BufferSize - file->af_SeekOffset - file->af_BytesLeft ) )
 			{
 				AS_RecordSyncFailure( file );
 				return( -1 );
@@ -280,6 +341,9 @@ SeekAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG position, _REG( d1 ) Seek
 		 * Problem: As it is now, Arg3 in the packet is always set to the buffer size.
 		 * With the above fix, this would have to be updated for each SendPacket (i.e.
 		 * a new argument would be needed).
+		 *
+		 * This is what is done for files opened with MODEF_DIRECT, see
+		 * AS_AlignWrite(). WriteAsync() sets Arg3 for each packet.
 		 */
 
 		current = Seek( file->af_File, position, mode );
@@ -290,9 +354,36 @@ SeekAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG position, _REG( d1 ) Seek
 			return( -1 );
 		}
 
+		/* keep the extra destinations in step */
+		{
+			struct AsyncTee	*tee;
+
+			for( tee = file->af_Tees; tee; tee = tee->at_Next )
+			{
+				if( Seek( tee->at_File, position, mode ) < 0 )
+				{
+					AS_RecordSyncFailure( file );
+					return( -1 );
+				}
+			}
+		}
+
 		file->af_BytesLeft	= file->af_BufferSize;
 		file->af_CurrentBuf	= 0;
 		file->af_Offset		= file->af_Buffers[ 0 ];
+		file->af_SeekOffset	= 0;
+
+		if( file->af_ModeFlags & MODEF_DIRECT )
+		{
+			/* Seek() returned the old position */
+			if( ( filePos = Seek( file->af_File, 0, OFFSET_CURRENT ) ) < 0 )
+			{
+				AS_RecordSyncFailure( file );
+				return( -1 );
+			}
+
+			AS_AlignWrite( file, filePos );
+		}
 	}
 
 	if( file->af_SeekPastEOF )
@@ -301,6 +392,8 @@ SeekAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) LONG position, _REG( d1 ) Seek
 		file->af_SeekPastEOF = FALSE;
 	}
 
+	file->af_DigestMark = file->af_Offset;
+
 	SetIoErr( 0 );
 	return( current );
 }
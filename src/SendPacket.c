@@ -1,6 +1,36 @@
 #include "async.h"
 
 
+/* a file with a maximum rate may only send its next packet once the bytes
+ * of the last one have had their time. Until then, the caller is put to
+ * sleep.
+ */
+static VOID
+Throttle( AsyncFile *file )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+	struct DateStamp	now;
+	LONG			ticks;
+
+	DateStamp( &now );
+
+	/* the ticks since SetPriorityAsync() */
+	ticks = ( now.ds_Days - file->af_RateBase.ds_Days ) * ( 24 * 60 * 60 * TICKS_PER_SECOND ) +
+		( now.ds_Minute - file->af_RateBase.ds_Minute ) * ( 60 * TICKS_PER_SECOND ) +
+		( now.ds_Tick - file->af_RateBase.ds_Tick );
+
+	if( file->af_RateNext > ticks )
+	{
+		Delay( file->af_RateNext - ticks );
+		ticks = file->af_RateNext;
+	}
+
+	file->af_RateNext = ticks + ( file->af_Packet.sp_Pkt.dp_Arg3 * TICKS_PER_SECOND ) / file->af_MaxRate;
+}
+
+
 /* send out an async packet to the file system. */
 VOID
 AS_SendPacket( struct AsyncFile *file, APTR arg2 )
@@ -11,8 +41,28 @@ AS_SendPacket( struct AsyncFile *file, APTR arg2 )
 	SysBase = file->af_SysBase;
 #endif
 
+	if( file->af_Packed )
+	{
+		AS_PackPacket( file, arg2 );
+		return;
+	}
+
+	if( file->af_MaxRate )
+	{
+		Throttle( file );
+	}
+
 	file->af_Packet.sp_Pkt.dp_Port = &file->af_PacketPort;
 	file->af_Packet.sp_Pkt.dp_Arg2 = ( LONG ) arg2;
-	PutMsg( file->af_Handler, &file->af_Packet.sp_Msg );
 	file->af_PacketPending = TRUE;
+
+	/* a scheduler may hold the packet back until it is the file's turn */
+	if( file->af_Scheduler )
+	{
+		AS_QueuePacket( file );
+	}
+	else
+	{
+		PutMsg( file->af_Handler, &file->af_Packet.sp_Msg );
+	}
 }
@@ -0,0 +1,171 @@
+#include "async.h"
+
+
+_LIBCALL LONG
+TeeAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) BPTR handle )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = file->af_SysBase;
+	struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+	struct FileHandle	*fh;
+	struct AsyncTee		*tee;
+
+	/* NIL: never sends a buffer, and a compressed file sends packed ones
+	 * of its own, so neither has buffers to share
+	 */
+	if( file->af_ReadMode || !file->af_Handler || file->af_Packed )
+	{
+		SetIoErr( ERROR_OBJECT_WRONG_TYPE );
+		return( -1 );
+	}
+
+	/* a new destination can only get complete buffers */
+	if( file->af_BytesLeft != file->af_BufferSize - file->af_SeekOffset )
+	{
+		SetIoErr( ERROR_OBJECT_IN_USE );
+		return( -1 );
+	}
+
+	if( !( tee = AllocVec( sizeof( struct AsyncTee ), MEMF_PUBLIC | MEMF_CLEAR ) ) )
+	{
+		SetIoErr( ERROR_NO_FREE_STORE );
+		return( -1 );
+	}
+
+	/* the packet is set up just like the one in the AsyncFile, and comes
+	 * back to the same port
+	 */
+	fh				= BADDR( handle );
+	tee->at_File			= handle;
+	tee->at_Handler			= fh->fh_Type;
+	tee->at_Packet.sp_Pkt.dp_Link	= &tee->at_Packet.sp_Msg;
+	tee->at_Packet.sp_Pkt.dp_Type	= ACTION_WRITE;
+	tee->at_Packet.sp_Pkt.dp_Arg1	= fh->fh_Arg1;
+	tee->at_Packet.sp_Msg.mn_Node.ln_Name	= ( STRPTR ) &tee->at_Packet.sp_Pkt;
+	tee->at_Packet.sp_Msg.mn_Node.ln_Type	= NT_MESSAGE;
+	tee->at_Packet.sp_Msg.mn_Length		= sizeof( struct StandardPacket );
+
+	tee->at_Next	= file->af_Tees;
+	file->af_Tees	= tee;
+
+	return( 0 );
+}
+
+
+/* send the same buffer to all extra destinations of the file */
+VOID
+AS_SendTees( AsyncFile *file, APTR arg2 )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = file->af_SysBase;
+#endif
+	struct AsyncTee	*tee;
+
+	for( tee = file->af_Tees; tee; tee = tee->at_Next )
+	{
+		if( tee->at_Handler )
+		{
+			tee->at_Packet.sp_Pkt.dp_Port = &file->af_PacketPort;
+			tee->at_Packet.sp_Pkt.dp_Arg2 = ( LONG ) arg2;
+			tee->at_Packet.sp_Pkt.dp_Arg3 = file->af_Packet.sp_Pkt.dp_Arg3;
+			PutMsg( tee->at_Handler, &tee->at_Packet.sp_Msg );
+			tee->at_PacketPending = TRUE;
+		}
+	}
+}
+
+
+/* Wait for the packets of all extra destinations to come back, so that the
+ * buffer they share can be reused. If the main packet comes back in the
+ * meantime, it is put back for AS_WaitPacket() to find. If a destination
+ * failed, the failure is recorded in the main packet, just like for a
+ * synchronous failure.
+ */
+VOID
+AS_WaitTees( AsyncFile *file )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = file->af_SysBase;
+#endif
+	struct AsyncTee	*tee;
+	struct Message	*msg;
+	LONG		error = 0;
+	BOOL		gotMain = FALSE;
+
+	for( tee = file->af_Tees; tee; tee = tee->at_Next )
+	{
+		while( tee->at_PacketPending )
+		{
+			file->af_PacketPort.mp_Flags = PA_SIGNAL;
+			msg = WaitPort( &file->af_PacketPort );
+			file->af_PacketPort.mp_Flags = IDLE_PORT_FLAGS( file );
+
+			/* several packets can be on their way to the port now, so
+			 * GetMsg() has to be used
+			 */
+			while( msg = GetMsg( &file->af_PacketPort ) )
+			{
+				struct AsyncTee	*t;
+
+				if( msg == &file->af_Packet.sp_Msg )
+				{
+					file->af_PacketPending = FALSE;
+					gotMain = TRUE;
+					continue;
+				}
+
+				for( t = file->af_Tees; t; t = t->at_Next )
+				{
+					if( msg == &t->at_Packet.sp_Msg )
+					{
+						t->at_PacketPending = FALSE;
+
+						if( t->at_Packet.sp_Pkt.dp_Res1 < 0 )
+						{
+							error = t->at_Packet.sp_Pkt.dp_Res2;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if( gotMain )
+	{
+		AS_RequeuePacket( file );
+	}
+
+	if( error )
+	{
+		/* make the error stick, once the main packet is back */
+		AS_WaitPacket( file );
+
+		file->af_LastRes1		= file->af_Packet.sp_Pkt.dp_Res1;
+		file->af_LastBytesLeft		= file->af_BytesLeft;
+		file->af_Packet.sp_Pkt.dp_Res1	= -1;
+		file->af_Packet.sp_Pkt.dp_Res2	= error;
+		file->af_BytesLeft		= 0;
+	}
+}
+
+
+/* synchronously write a partial buffer to all extra destinations */
+BOOL
+AS_WriteTees( AsyncFile *file, APTR buffer, LONG length )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+	struct AsyncTee		*tee;
+
+	for( tee = file->af_Tees; tee; tee = tee->at_Next )
+	{
+		if( Write( tee->at_File, buffer, length ) < 0 )
+		{
+			return( FALSE );
+		}
+	}
+
+	return( TRUE );
+}
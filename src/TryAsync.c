@@ -0,0 +1,210 @@
+#include "async.h"
+
+#include <devices/timer.h>
+
+
+_LIBCALL LONG
+TryReadAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG numBytes )
+{
+	LONG	totalBytes = 0;
+	LONG	bytes;
+
+	while( numBytes > 0 )
+	{
+		if( !file->af_BytesLeft )
+		{
+			/* only flip buffers if the next one is already here */
+			if( !AS_FileReady( file ) )
+			{
+				break;
+			}
+
+			if( ( bytes = AS_FillBuffer( file ) ) <= 0 )
+			{
+				if( ( bytes < 0 ) && !totalBytes )
+				{
+					return( -1 );
+				}
+
+				/* end of file */
+				return( totalBytes );
+			}
+		}
+
+		bytes = MIN( numBytes, file->af_BytesLeft );
+
+		/* this never goes past the current buffer */
+		ReadAsync( file, buffer, bytes );
+
+		buffer		=  ( APTR ) ( ( ULONG ) buffer + bytes );
+		numBytes	-= bytes;
+		totalBytes	+= bytes;
+	}
+
+	if( !totalBytes && numBytes )
+	{
+		return( ASYNC_NOTREADY );
+	}
+
+	return( totalBytes );
+}
+
+
+_LIBCALL LONG
+TryWriteAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG numBytes )
+{
+	LONG	totalBytes = 0;
+	LONG	bytes;
+
+	while( numBytes > 0 )
+	{
+		if( file->af_BytesLeft )
+		{
+			bytes = MIN( numBytes, file->af_BytesLeft );
+		}
+		else
+		{
+			/* the buffer is full; only send it if the other one is back */
+			if( !AS_FileReady( file ) )
+			{
+				break;
+			}
+
+			bytes = MIN( numBytes, file->af_BufferSize );
+		}
+
+		if( WriteAsync( file, buffer, bytes ) < 0 )
+		{
+			return( totalBytes ? totalBytes : -1 );
+		}
+
+		buffer		=  ( APTR ) ( ( ULONG ) buffer + bytes );
+		numBytes	-= bytes;
+		totalBytes	+= bytes;
+	}
+
+	return( totalBytes );
+}
+
+
+/* wait until the next buffer of file is there, or until the timeout (in
+ * microseconds) has passed. Returns -1 if the timer couldn't be used.
+ */
+static LONG
+WaitReady( AsyncFile *file, LONG timeout )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*SysBase = file->af_SysBase;
+	struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+	struct MsgPort		*timerPort;
+	struct timerequest	*timerReq;
+	AsyncFile		*io, *busy;
+	ULONG			portMask, busyMask;
+	BOOL			ready;
+	LONG			result = -1;
+
+	/* the packets of a compressed file come back to the file it reads from */
+	io = file->af_Packed ? file->af_Packed->ap_File : file;
+
+	if( timerPort = CreateMsgPort() )
+	{
+		if( timerReq = ( struct timerequest * ) CreateIORequest( timerPort, sizeof( struct timerequest ) ) )
+		{
+			if( !OpenDevice( TIMERNAME, UNIT_MICROHZ, ( struct IORequest * ) timerReq, 0 ) )
+			{
+				timerReq->tr_node.io_Command	= TR_ADDREQUEST;
+				timerReq->tr_time.tv_secs	= timeout / 1000000;
+				timerReq->tr_time.tv_micro	= timeout % 1000000;
+				SendIO( ( struct IORequest * ) timerReq );
+
+				/* let the port signal while we wait, like AS_WaitPacket() */
+				portMask			= 1UL << io->af_PacketPort.mp_SigBit;
+				io->af_PacketPort.mp_Flags	= PA_SIGNAL;
+
+				while( TRUE )
+				{
+					/* a packet held by a scheduler can only go out once
+					 * the file that has the device gets its packet back,
+					 * so that port has to signal as well
+					 */
+					busyMask = 0;
+
+					if( busy = AS_BusyFile( io ) )
+					{
+						busyMask			= 1UL << busy->af_PacketPort.mp_SigBit;
+						busy->af_PacketPort.mp_Flags	= PA_SIGNAL;
+					}
+
+					if( !( ready = AS_FileReady( file ) ) && !CheckIO( ( struct IORequest * ) timerReq ) )
+					{
+						Wait( portMask | busyMask | ( 1UL << timerPort->mp_SigBit ) );
+					}
+
+					if( busy )
+					{
+						busy->af_PacketPort.mp_Flags = IDLE_PORT_FLAGS( busy );
+					}
+
+					if( ready || CheckIO( ( struct IORequest * ) timerReq ) )
+					{
+						break;
+					}
+				}
+
+				io->af_PacketPort.mp_Flags = IDLE_PORT_FLAGS( io );
+
+				if( !CheckIO( ( struct IORequest * ) timerReq ) )
+				{
+					AbortIO( ( struct IORequest * ) timerReq );
+				}
+
+				WaitIO( ( struct IORequest * ) timerReq );
+				CloseDevice( ( struct IORequest * ) timerReq );
+				result = 0;
+			}
+			else
+			{
+				SetIoErr( ERROR_OBJECT_NOT_FOUND );
+			}
+
+			DeleteIORequest( ( struct IORequest * ) timerReq );
+		}
+		else
+		{
+			SetIoErr( ERROR_NO_FREE_STORE );
+		}
+
+		DeleteMsgPort( timerPort );
+	}
+	else
+	{
+		SetIoErr( ERROR_NO_FREE_STORE );
+	}
+
+	return( result );
+}
+
+
+_LIBCALL LONG
+ReadSomeAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG numBytes, _REG( d1 ) LONG timeout )
+{
+	if( ( numBytes > 0 ) && !file->af_BytesLeft && !AS_FileReady( file ) )
+	{
+		if( timeout < 0 )
+		{
+			/* no timeout, so just wait for the buffer */
+			if( AS_FillBuffer( file ) < 0 )
+			{
+				return( -1 );
+			}
+		}
+		else if( timeout && ( WaitReady( file, timeout ) < 0 ) )
+		{
+			return( -1 );
+		}
+	}
+
+	/* takes what is there, if anything */
+	return( TryReadAsync( file, buffer, numBytes ) );
+}
@@ -0,0 +1,125 @@
+#include "async.h"
+
+#include <stdarg.h>
+
+
+/*****************************************************************************/
+
+
+/* RawDoFmt() always calls the PutChProc with the character in d0 and the
+ * user data in a3, no matter how the rest of the library is compiled.
+ */
+#ifdef _DCC
+#define _PUTCH	__regargs
+#define _PREG(x)	__ ## x
+#else
+#ifdef __GNUC__
+#define _PUTCH
+#define _PREG(x)
+#else /* __SASC__ */
+#define _PUTCH	__asm
+#define _PREG(x)	register __ ## x
+#endif /* __GNUC__ */
+#endif /* _DCC */
+
+
+struct FormatData
+{
+	AsyncFile	*fd_File;
+	LONG		fd_Count;
+	BOOL		fd_Error;
+};
+
+
+static _PUTCH VOID
+PutCh( _PREG( d0 ) UBYTE ch, _PREG( a3 ) struct FormatData *fd )
+{
+	AsyncFile	*file = fd->fd_File;
+
+	if( fd->fd_Error )
+	{
+		return;
+	}
+
+	if( file->af_BytesLeft )
+	{
+		/* the common case; the character goes straight into the
+		 * current buffer
+		 */
+
+		*file->af_Offset = ch;
+		--file->af_BytesLeft;
+		++file->af_Offset;
+	}
+	else if( WriteCharAsync( file, ch ) < 0 )
+	{
+		/* buffer full and the flip failed. Keep RawDoFmt() happy, but
+		 * don't touch the file any more.
+		 */
+
+		fd->fd_Error = TRUE;
+		return;
+	}
+
+	++fd->fd_Count;
+}
+
+
+/*****************************************************************************/
+
+
+_LIBCALL LONG
+VFPrintfAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) STRPTR fmt, _REG( a2 ) APTR args )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = file->af_SysBase;
+#endif
+	struct FormatData fd;
+
+	fd.fd_File	= file;
+	fd.fd_Count	= 0;
+	fd.fd_Error	= FALSE;
+
+	RawDoFmt( fmt, args, ( VOID (*)() ) PutCh, &fd );
+
+	if( fd.fd_Error )
+	{
+		return( -1 );
+	}
+
+	/* RawDoFmt() always ends with a null-terminator, which we don't want
+	 * in the file. WriteCharAsync() normally leaves it as the last byte of
+	 * the current buffer, even if it filled it, so simply take it back. A
+	 * NIL: file drops a full buffer at once, taking the null with it, so
+	 * then there is nothing to take back.
+	 */
+	if( fd.fd_Count )
+	{
+		if( file->af_BytesLeft < file->af_BufferSize )
+		{
+			--file->af_Offset;
+			++file->af_BytesLeft;
+		}
+
+		--fd.fd_Count;
+	}
+
+	return( fd.fd_Count );
+}
+
+
+/* Stack based stub for VFPrintfAsync(). Users of the shared library get
+ * the same thing from the tagcall pragma.
+ */
+LONG
+FPrintfAsync( AsyncFile *file, STRPTR fmt, ... )
+{
+	va_list	args;
+	LONG	result;
+
+	va_start( args, fmt );
+	result = VFPrintfAsync( file, fmt, ( APTR ) args );
+	va_end( args );
+
+	return( result );
+}
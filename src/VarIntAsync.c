@@ -0,0 +1,79 @@
+#include "async.h"
+
+
+/* a 32 bit number needs at most five groups of seven bits */
+#define MAX_VARINT	5
+
+
+_LIBCALL LONG
+ReadVarIntAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) ULONG *value )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+	ULONG	result = 0;
+	LONG	numBytes = 0;
+	LONG	left;
+	UBYTE	ch;
+
+	do
+	{
+		if( !file->af_BytesLeft && ( ( left = AS_FillBuffer( file ) ) <= 0 ) )
+		{
+			if( !left && numBytes )
+			{
+				/* EOF in the middle of a number */
+				SetIoErr( ERROR_BAD_NUMBER );
+				return( -1 );
+			}
+
+			return( left );
+		}
+
+		if( ( numBytes == MAX_VARINT - 1 ) && ( *file->af_Offset > 0x0f ) )
+		{
+			/* doesn't fit in 32 bits (or is too long) */
+			SetIoErr( ERROR_BAD_NUMBER );
+			return( -1 );
+		}
+
+		ch = *file->af_Offset++;
+		--file->af_BytesLeft;
+
+		result |= ( ULONG ) ( ch & 0x7f ) << ( numBytes * 7 );
+		++numBytes;
+	}
+	while( ch & 0x80 );
+
+	*value = result;
+	return( numBytes );
+}
+
+
+_LIBCALL LONG
+WriteVarIntAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) ULONG value )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = file->af_SysBase;
+#endif
+	UBYTE	buf[ MAX_VARINT ];
+	LONG	numBytes = 0;
+
+	while( value > 0x7f )
+	{
+		buf[ numBytes++ ] = ( UBYTE ) ( value | 0x80 );
+		value >>= 7;
+	}
+
+	buf[ numBytes++ ] = ( UBYTE ) value;
+
+	if( numBytes <= file->af_BytesLeft )
+	{
+		CopyMem( buf, file->af_Offset, numBytes );
+		file->af_BytesLeft	-= numBytes;
+		file->af_Offset		+= numBytes;
+		return( numBytes );
+	}
+
+	return( WriteAsync( file, buf, numBytes ) );
+}
@@ -18,10 +18,22 @@ AS_WaitPacket( AsyncFile *file )
 #endif
 	LONG bytes;
 
+	/* the buffer may also be in use by the packets to other destinations */
+	if( file->af_Tees )
+	{
+		AS_WaitTees( file );
+	}
+
 	if( file->af_PacketPending )
 	{
 		while( TRUE )
 		{
+			/* a packet held by a scheduler has to go out first */
+			if( file->af_Ticket )
+			{
+				AS_ReleasePacket( file, TRUE );
+			}
+
 			/* This enables signalling when a packet comes back to the port */
 			file->af_PacketPort.mp_Flags = PA_SIGNAL;
 
@@ -34,9 +46,9 @@ AS_WaitPacket( AsyncFile *file )
 			Remove( ( struct Node * ) WaitPort( &file->af_PacketPort ) );
 
 			/* set the port type back to PA_IGNORE so we won't be bothered with
-			 * spurious signals
+			 * spurious signals (unless the file is in a group)
 			 */
-			file->af_PacketPort.mp_Flags = PA_IGNORE;
+			file->af_PacketPort.mp_Flags = IDLE_PORT_FLAGS( file );
 
 			/* mark packet as no longer pending since we removed it */
 			file->af_PacketPending = FALSE;
@@ -55,11 +67,11 @@ AS_WaitPacket( AsyncFile *file )
 				return( -1 );
 			}
 
-			/* user wants to try again, resend the packet */
-			AS_SendPacket( file,
-				file->af_Buffers[ file->af_ReadMode ?
-					file->af_CurrentBuf :
-					1 - file->af_CurrentBuf ] );
+			/* user wants to try again, resend the packet, with the same
+			 * buffer (which may not be at the start of af_Buffers[] after
+			 * an aligned seek)
+			 */
+			AS_SendPacket( file, ( APTR ) file->af_Packet.sp_Pkt.dp_Arg2 );
 		}
 	}
 
@@ -14,6 +14,7 @@ WriteAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG
 	{
 		file->af_Offset		= file->af_Buffers[ 0 ];
 		file->af_BytesLeft	= file->af_BufferSize;
+		file->af_DigestMark	= file->af_Offset;
 		return( numBytes );
 	}
 
@@ -28,17 +29,33 @@ WriteAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG
 			totalBytes	+= file->af_BytesLeft;
 		}
 
+		if( file->af_DigestType )
+		{
+			AS_UpdateDigest( file, file->af_Offset + file->af_BytesLeft );
+		}
+
 		if( AS_WaitPacket( file ) < 0 )
 		{
 			return( -1 );
 		}
 
-		/* send the current buffer out to disk */
-		AS_SendPacket( file, file->af_Buffers[ file->af_CurrentBuf ] );
+		/* send the current buffer out to disk. After an aligned seek, the
+		 * data starts af_SeekOffset bytes into the buffer
+		 */
+		file->af_Packet.sp_Pkt.dp_Arg3 = file->af_BufferSize - file->af_SeekOffset;
+		AS_SendPacket( file, file->af_Buffers[ file->af_CurrentBuf ] + file->af_SeekOffset );
+
+		if( file->af_Tees )
+		{
+			AS_SendTees( file, file->af_Buffers[ file->af_CurrentBuf ] + file->af_SeekOffset );
+		}
+
+		file->af_SeekOffset	= 0;
 
 		file->af_CurrentBuf	= 1 - file->af_CurrentBuf;
 		file->af_Offset		= file->af_Buffers[ file->af_CurrentBuf ];
 		file->af_BytesLeft	= file->af_BufferSize;
+		file->af_DigestMark	= file->af_Offset;
 	}
 
 	CopyMem( buffer, file->af_Offset, numBytes );
@@ -0,0 +1,79 @@
+#include "async.h"
+
+
+#define MAX_BITS	24
+
+
+_LIBCALL LONG
+WriteBitsAsync( _REG( a0 ) AsyncFile *file, _REG( d0 ) ULONG value, _REG( d1 ) LONG numBits )
+{
+	ULONG	bits;
+	LONG	count;
+	UBYTE	ch;
+
+	if( ( numBits <= 0 ) || ( numBits > MAX_BITS ) )
+	{
+		return( -1 );
+	}
+
+	bits	= ( file->af_BitBuffer << numBits ) | ( value & ( ( 1UL << numBits ) - 1 ) );
+	count	= file->af_BitCount + numBits;
+
+	/* send out all complete bytes */
+	while( count >= 8 )
+	{
+		count	-= 8;
+		ch	= ( UBYTE ) ( bits >> count );
+
+		if( file->af_BytesLeft )
+		{
+			*file->af_Offset = ch;
+			--file->af_BytesLeft;
+			++file->af_Offset;
+		}
+		else if( WriteCharAsync( file, ch ) < 0 )
+		{
+			file->af_BitCount = 0;
+			return( -1 );
+		}
+	}
+
+	file->af_BitBuffer	= bits & ( ( 1UL << count ) - 1 );
+	file->af_BitCount	= count;
+
+	return( numBits );
+}
+
+
+_LIBCALL LONG
+AlignBitsAsync( _REG( a0 ) AsyncFile *file )
+{
+	if( file->af_ReadMode )
+	{
+		LONG	bytes = file->af_BitCount / 8;
+
+		/* skip the rest of the current byte */
+		file->af_BitCount	= 0;
+		file->af_BitBuffer	= 0;
+
+		/* PeekBitsAsync() has to take whole bytes out of a buffer
+		 * before it can look into the next one. That buffer is being
+		 * refilled by now, so go back to read them again with the byte
+		 * functions.
+		 */
+		if( bytes && ( SeekAsync( file, -bytes, MODE_CURRENT ) < 0 ) )
+		{
+			return( -1 );
+		}
+	}
+	else if( file->af_BitCount )
+	{
+		/* pad the last byte with zero bits */
+		if( WriteBitsAsync( file, 0, 8 - file->af_BitCount ) < 0 )
+		{
+			return( -1 );
+		}
+	}
+
+	return( 0 );
+}
@@ -0,0 +1,59 @@
+#include "async.h"
+
+
+_LIBCALL LONG
+WriteEndianAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) APTR buffer, _REG( d0 ) LONG count, _REG( d1 ) ULONG format )
+{
+	UBYTE	*from = buffer;
+	LONG	size = format & AEF_SIZEMASK;
+	LONG	numWritten = 0;
+	LONG	num;
+
+	/* elements are 1, 2, 4 or 8 bytes */
+	if( ( size != 1 ) && ( size != 2 ) && ( size != 4 ) && ( size != 8 ) )
+	{
+#ifdef ASIO_NOEXTERNALS
+		struct DosLibrary	*DOSBase = file->af_DOSBase;
+#endif
+
+		SetIoErr( ERROR_BAD_NUMBER );
+		return( -1 );
+	}
+
+	while( count > 0 )
+	{
+		if( ( num = file->af_BytesLeft / size ) != 0 )
+		{
+			/* convert as many elements as there is room for in the
+			 * current buffer
+			 */
+
+			num = MIN( num, count );
+			AS_CopyEndian( file, from, file->af_Offset, num, format );
+			file->af_BytesLeft	-= num * size;
+			file->af_Offset		+= num * size;
+		}
+		else
+		{
+			UBYTE	tmp[ AEF_SIZEMASK ];
+
+			/* the element won't fit, so let WriteAsync() split it
+			 * over the two buffers
+			 */
+
+			num = 1;
+			AS_CopyEndian( file, from, tmp, 1, format );
+
+			if( WriteAsync( file, tmp, size ) < 0 )
+			{
+				return( -1 );
+			}
+		}
+
+		from		+= num * size;
+		count		-= num;
+		numWritten	+= num;
+	}
+
+	return( numWritten );
+}
@@ -0,0 +1,79 @@
+#include "async.h"
+
+
+_LIBCALL LONG
+WriteVAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) struct AsyncIOVec *vec, _REG( d0 ) LONG count )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = file->af_SysBase;
+#endif
+	LONG totalBytes = 0;
+
+	for( ; count > 0; --count, ++vec )
+	{
+		if( vec->iov_Len <= file->af_BytesLeft )
+		{
+			/* there's room for the whole element in the current buffer,
+			 * so put it there directly
+			 */
+
+			CopyMem( vec->iov_Base, file->af_Offset, vec->iov_Len );
+			file->af_BytesLeft	-= vec->iov_Len;
+			file->af_Offset		+= vec->iov_Len;
+		}
+		else
+		{
+			/* let WriteAsync() fill up the buffer and send it out */
+			if( WriteAsync( file, vec->iov_Base, vec->iov_Len ) < 0 )
+			{
+				return( -1 );
+			}
+		}
+
+		totalBytes += vec->iov_Len;
+	}
+
+	return( totalBytes );
+}
+
+
+_LIBCALL LONG
+WriteLinesAsync( _REG( a0 ) AsyncFile *file, _REG( a1 ) STRPTR *lines,
+	_REG( a2 ) LONG *lengths, _REG( d0 ) LONG count )
+{
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase	*SysBase = file->af_SysBase;
+#endif
+	LONG totalBytes = 0;
+	LONG len;
+
+	for( ; count > 0; --count, ++lines )
+	{
+		if( lengths )
+		{
+			len = *lengths++;
+		}
+		else
+		{
+			len = strlen( *lines );
+		}
+
+		if( len <= file->af_BytesLeft )
+		{
+			CopyMem( *lines, file->af_Offset, len );
+			file->af_BytesLeft	-= len;
+			file->af_Offset		+= len;
+		}
+		else
+		{
+			if( WriteAsync( file, *lines, len ) < 0 )
+			{
+				return( -1 );
+			}
+		}
+
+		totalBytes += len;
+	}
+
+	return( totalBytes );
+}
@@ -60,6 +60,140 @@ extern struct DosLibrary	*DOSBase;
 /*****************************************************************************/
 
 
+/* An extra destination for the data written to a file, see TeeAsync().
+ * The packet is sent with the same buffer as the one in the AsyncFile.
+ */
+struct AsyncTee
+{
+	struct AsyncTee		*at_Next;
+	BPTR			at_File;
+	struct MsgPort		*at_Handler;
+	struct StandardPacket	at_Packet;
+	UBYTE			at_PacketPending;
+};
+
+
+/* A compressed file reads and writes the packed data through another
+ * AsyncFile, see Compress.c. The buffer holds one compressed block.
+ */
+#define PACK_BLOCKSIZE	32768
+#define PACK_HASHSIZE	4096
+#define PACK_HEADERSIZE	8
+
+struct AsyncPack
+{
+	AsyncFile	*ap_File;
+	UWORD		ap_Hash[ PACK_HASHSIZE ];
+	UBYTE		ap_Buffer[ PACK_HEADERSIZE + PACK_BLOCKSIZE ];
+};
+
+
+/* the number of volumes AS_OpenAsyncFH() remembers the block size of */
+#define GEOMETRY_CACHESIZE	8
+
+/* OpenAsyncBatch() keeps this many files being opened ahead of the one
+ * handed out by NextAsyncBatch()
+ */
+#define BATCH_AHEAD	4
+
+struct AsyncOpening
+{
+	struct StandardPacket	ao_Packet;
+	ULONG			ao_Name[ 64 ];	/* BSTR, longword aligned */
+	struct DevProc		*ao_DevProc;
+	struct FileHandle	*ao_Handle;
+	AsyncFile		*ao_File;
+	LONG			ao_Index;
+	LONG			ao_Error;
+	UBYTE			ao_Pending;
+};
+
+struct AsyncBatch
+{
+	STRPTR			*ab_Names;
+	struct AsyncDir		*ab_Dir;	/* or take the names from here */
+	LONG			ab_Count;
+	LONG			ab_Next;	/* next file NextAsyncBatch() returns */
+	LONG			ab_Sent;	/* next file to start opening */
+	OpenModes		ab_Mode;
+	LONG			ab_BufferSize;
+	UBYTE			ab_Name[ 256 ];	/* of the last file returned from ab_Dir */
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*ab_SysBase;
+	struct DosLibrary	*ab_DOSBase;
+#endif
+	struct MsgPort		ab_Port;
+	struct AsyncOpening	ab_Opening[ BATCH_AHEAD ];
+};
+
+/* the packets of the files in a scheduler that go to one device */
+struct AsyncQueue
+{
+	struct AsyncQueue	*aq_Next;
+	struct MsgPort		*aq_Handler;
+	AsyncFile		*aq_Busy;	/* file whose packet is out */
+	AsyncFile		*aq_Owner;	/* file whose turn it is */
+	LONG			aq_TurnLeft;	/* packets the owner may still send */
+};
+
+struct AsyncScheduler
+{
+	AsyncFile		*as_Files;
+	struct AsyncQueue	*as_Queues;
+	LONG			as_Turn;
+	ULONG			as_Ticket;	/* the last one handed out */
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*as_SysBase;
+#endif
+};
+
+/* OpenAsyncDir() reads the entries into one buffer while the other one is
+ * being worked through, like an AsyncFile in read mode
+ */
+struct AsyncDir
+{
+	struct StandardPacket	ad_Packet;
+	struct MsgPort		ad_Port;
+	BPTR			ad_Lock;
+	struct ExAllControl	*ad_Control;
+	struct ExAllData	*ad_Buffers[ 2 ];
+	struct ExAllData	*ad_Next;	/* next entry ReadAsyncDir() returns */
+	LONG			ad_BufferSize;	/* of each buffer */
+	LONG			ad_Type;
+	LONG			ad_Error;	/* why there are no more entries */
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*ad_SysBase;
+	struct DosLibrary	*ad_DOSBase;
+#endif
+	UBYTE			ad_CurrentBuf;
+	UBYTE			ad_PacketPending;
+	UBYTE			ad_Emulate;	/* the handler doesn't know ACTION_EXAMINE_ALL */
+};
+
+/* OpenAsyncScan() reads each range of the file through a file of its own,
+ * as a file handle only has one position to read from
+ */
+struct AsyncRange
+{
+	AsyncFile		*ar_File;	/* NULL once the range has been read */
+	LONG			ar_Left;	/* bytes of the range still to be read */
+};
+
+struct AsyncScan
+{
+	struct AsyncGroup	*asc_Group;
+	LONG			asc_Count;
+#ifdef ASIO_NOEXTERNALS
+	struct ExecBase		*asc_SysBase;
+	struct DosLibrary	*asc_DOSBase;
+#endif
+	struct AsyncRange	asc_Ranges[ 1 ];	/* asc_Count of them */
+};
+
+
+/*****************************************************************************/
+
+
 /* this macro lets us long-align structures on the stack */
 #define D_S(type,name) char a_##name[ sizeof( type ) + 3 ]; \
 			type *name = ( type * ) ( ( LONG ) ( a_##name + 3 ) & ~3 );
@@ -68,6 +202,21 @@ extern struct DosLibrary	*DOSBase;
 #define MIN(a,b) ( ( a ) < ( b ) ? ( a ) : ( b ) )
 #endif
 
+/* the port flags of a file while nothing waits on it. The port of a file
+ * in a group signals the group whenever a packet comes back.
+ */
+#define IDLE_PORT_FLAGS(file) ( ( file )->af_Group ? PA_SIGNAL : PA_IGNORE )
+
+/* the open mode without any MODEF_ flags */
+#define OPEN_MODE(mode) ( ( OpenModes ) ( ( mode ) & 0xff ) )
+
+/* Returns 0x80 in each byte of word that is a newline, and 0 in the
+ * others. Unlike the usual "has a zero byte" test, this one is exact for
+ * every byte, so the bits can be counted.
+ */
+#define NEWLINES(word)	( ~( ( ( ( ( word ) ^ 0x0a0a0a0a ) & 0x7f7f7f7f ) + 0x7f7f7f7f ) | \
+			  ( ( word ) ^ 0x0a0a0a0a ) ) & 0x80808080 )
+
 
 /*****************************************************************************/
 
@@ -75,12 +224,34 @@ extern struct DosLibrary	*DOSBase;
 #ifdef ASIO_NOEXTERNALS
 AsyncFile *
 AS_OpenAsyncFH( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt, struct ExecBase *SysBase, struct DosLibrary *DOSBase );
+struct AsyncPack *
+AS_OpenPack( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt, struct ExecBase *SysBase, struct DosLibrary *DOSBase );
+LONG AS_CachedBlockSize( struct MsgPort *handler, struct ExecBase *SysBase, struct DosLibrary *DOSBase );
+VOID AS_CacheBlockSize( struct MsgPort *handler, LONG blockSize, struct ExecBase *SysBase, struct DosLibrary *DOSBase );
 #else
 AsyncFile *
 AS_OpenAsyncFH( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt );
+struct AsyncPack *
+AS_OpenPack( BPTR handle, OpenModes mode, LONG bufferSize, BOOL closeIt );
+LONG AS_CachedBlockSize( struct MsgPort *handler );
+VOID AS_CacheBlockSize( struct MsgPort *handler, LONG blockSize );
 #endif
 VOID AS_SendPacket( AsyncFile *file, APTR arg2 );
 LONG AS_WaitPacket( AsyncFile *file );
 VOID AS_RequeuePacket( AsyncFile *file );
 VOID AS_RecordSyncFailure( AsyncFile *file );
+LONG AS_FillBuffer( AsyncFile *file );
+VOID AS_CopyEndian( AsyncFile *file, UBYTE *from, UBYTE *to, LONG count, ULONG format );
+VOID AS_SendTees( AsyncFile *file, APTR arg2 );
+VOID AS_WaitTees( AsyncFile *file );
+BOOL AS_WriteTees( AsyncFile *file, APTR buffer, LONG length );
+VOID AS_UpdateDigest( AsyncFile *file, UBYTE *end );
+VOID AS_PackPacket( AsyncFile *file, APTR arg2 );
+LONG AS_PackBuffer( AsyncFile *file, UBYTE *buffer, LONG length );
+LONG AS_ClosePack( struct AsyncPack *pack );
+VOID AS_AlignWrite( AsyncFile *file, LONG position );
+BOOL AS_FileReady( AsyncFile *file );
+VOID AS_QueuePacket( AsyncFile *file );
+VOID AS_ReleasePacket( AsyncFile *file, BOOL wait );
+AsyncFile *AS_BusyFile( AsyncFile *file );
 
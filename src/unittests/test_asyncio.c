@@ -190,6 +190,29 @@ BOOL test_error_handling(void);
 BOOL test_file_handle_operations(void);
 BOOL test_sophisticated_files(void);
 BOOL test_file_copy_validation(void);
+BOOL test_vector_operations(void);
+BOOL test_format_operations(void);
+BOOL test_number_operations(void);
+BOOL test_endian_operations(void);
+BOOL test_bit_operations(void);
+BOOL test_inline_char_operations(void);
+BOOL test_copy_operations(void);
+BOOL test_tee_operations(void);
+BOOL test_digest_operations(void);
+BOOL test_compressed_operations(void);
+BOOL test_find_operations(void);
+BOOL test_count_lines(void);
+BOOL test_line_index(void);
+BOOL test_in_place_operations(void);
+BOOL test_direct_operations(void);
+BOOL test_group_operations(void);
+BOOL test_try_operations(void);
+BOOL test_batch_operations(void);
+BOOL test_geometry_cache(void);
+BOOL test_dir_operations(void);
+BOOL test_scheduler_operations(void);
+BOOL test_priority_operations(void);
+BOOL test_scan_operations(void);
 void cleanup_test_files(void);
 void print_test_summary(void);
 
@@ -417,6 +440,29 @@ int main(int argc, char *argv[])
     BOOL file_handle_ops_passed;
     BOOL sophisticated_files_passed;
     BOOL file_copy_validation_passed;
+    BOOL vector_ops_passed;
+    BOOL format_ops_passed;
+    BOOL number_ops_passed;
+    BOOL endian_ops_passed;
+    BOOL bit_ops_passed;
+    BOOL inline_char_ops_passed;
+    BOOL copy_ops_passed;
+    BOOL tee_ops_passed;
+    BOOL digest_ops_passed;
+    BOOL compressed_ops_passed;
+    BOOL find_ops_passed;
+    BOOL count_lines_passed;
+    BOOL line_index_passed;
+    BOOL in_place_passed;
+    BOOL direct_passed;
+    BOOL group_passed;
+    BOOL try_passed;
+    BOOL batch_passed;
+    BOOL geometry_passed;
+    BOOL dir_passed;
+    BOOL scheduler_passed;
+    BOOL priority_passed;
+    BOOL scan_passed;
     
     printf("=== AsyncIO Library Unit Test Suite ===\n");
     printf("Testing all functions from asyncio.doc\n\n");
@@ -603,6 +649,259 @@ int main(int argc, char *argv[])
     TRACE("=== Test 11 completed ===");
     wait_for_async_operation(); /* Ensure cleanup between tests */
 
+    /* Test 12: Vector operations (independent) */
+    TRACE("=== Starting Test 12: Vector operations ===");
+    vector_ops_passed = test_vector_operations();
+    if (vector_ops_passed) {
+        printf("Vector operation tests completed\n");
+    } else {
+        TRACE("Vector operation tests failed");
+    }
+    TRACE("=== Test 12 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 13: Formatted output (independent) */
+    TRACE("=== Starting Test 13: Formatted output ===");
+    format_ops_passed = test_format_operations();
+    if (format_ops_passed) {
+        printf("Formatted output tests completed\n");
+    } else {
+        TRACE("Formatted output tests failed");
+    }
+    TRACE("=== Test 13 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 14: Number parsing (independent) */
+    TRACE("=== Starting Test 14: Number parsing ===");
+    number_ops_passed = test_number_operations();
+    if (number_ops_passed) {
+        printf("Number parsing tests completed\n");
+    } else {
+        TRACE("Number parsing tests failed");
+    }
+    TRACE("=== Test 14 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 15: Endian conversion (independent) */
+    TRACE("=== Starting Test 15: Endian conversion ===");
+    endian_ops_passed = test_endian_operations();
+    if (endian_ops_passed) {
+        printf("Endian conversion tests completed\n");
+    } else {
+        TRACE("Endian conversion tests failed");
+    }
+    TRACE("=== Test 15 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 16: Bitstreams and varints (independent) */
+    TRACE("=== Starting Test 16: Bitstreams and varints ===");
+    bit_ops_passed = test_bit_operations();
+    if (bit_ops_passed) {
+        printf("Bitstream tests completed\n");
+    } else {
+        TRACE("Bitstream tests failed");
+    }
+    TRACE("=== Test 16 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 17: Inline character macros (independent) */
+    TRACE("=== Starting Test 17: Inline character macros ===");
+    inline_char_ops_passed = test_inline_char_operations();
+    if (inline_char_ops_passed) {
+        printf("Inline character macro tests completed\n");
+    } else {
+        TRACE("Inline character macro tests failed");
+    }
+    TRACE("=== Test 17 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 18: File to file copy (independent) */
+    TRACE("=== Starting Test 18: File to file copy ===");
+    copy_ops_passed = test_copy_operations();
+    if (copy_ops_passed) {
+        printf("File to file copy tests completed\n");
+    } else {
+        TRACE("File to file copy tests failed");
+    }
+    TRACE("=== Test 18 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 19: Tee output (independent) */
+    TRACE("=== Starting Test 19: Tee output ===");
+    tee_ops_passed = test_tee_operations();
+    if (tee_ops_passed) {
+        printf("Tee output tests completed\n");
+    } else {
+        TRACE("Tee output tests failed");
+    }
+    TRACE("=== Test 19 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 20: Streaming digests (independent) */
+    TRACE("=== Starting Test 20: Streaming digests ===");
+    digest_ops_passed = test_digest_operations();
+    if (digest_ops_passed) {
+        printf("Streaming digest tests completed\n");
+    } else {
+        TRACE("Streaming digest tests failed");
+    }
+    TRACE("=== Test 20 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 21: Compressed files (independent) */
+    TRACE("=== Starting Test 21: Compressed files ===");
+    compressed_ops_passed = test_compressed_operations();
+    if (compressed_ops_passed) {
+        printf("Compressed file tests completed\n");
+    } else {
+        TRACE("Compressed file tests failed");
+    }
+    TRACE("=== Test 21 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 22: Searching (independent) */
+    TRACE("=== Starting Test 22: Searching ===");
+    find_ops_passed = test_find_operations();
+    if (find_ops_passed) {
+        printf("Search tests completed\n");
+    } else {
+        TRACE("Search tests failed");
+    }
+    TRACE("=== Test 22 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 23: Line counting (independent) */
+    TRACE("=== Starting Test 23: Line counting ===");
+    count_lines_passed = test_count_lines();
+    if (count_lines_passed) {
+        printf("Line counting tests completed\n");
+    } else {
+        TRACE("Line counting tests failed");
+    }
+    TRACE("=== Test 23 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 24: Line index (independent) */
+    TRACE("=== Starting Test 24: Line index ===");
+    line_index_passed = test_line_index();
+    if (line_index_passed) {
+        printf("Line index tests completed\n");
+    } else {
+        TRACE("Line index tests failed");
+    }
+    TRACE("=== Test 24 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 25: In-place buffer access (independent) */
+    TRACE("=== Starting Test 25: In-place buffer access ===");
+    in_place_passed = test_in_place_operations();
+    if (in_place_passed) {
+        printf("In-place buffer access tests completed\n");
+    } else {
+        TRACE("In-place buffer access tests failed");
+    }
+    TRACE("=== Test 25 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 26: Block-aligned direct files (independent) */
+    TRACE("=== Starting Test 26: Block-aligned direct files ===");
+    direct_passed = test_direct_operations();
+    if (direct_passed) {
+        printf("Direct file tests completed\n");
+    } else {
+        TRACE("Direct file tests failed");
+    }
+    TRACE("=== Test 26 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 27: Waiting for several files (independent) */
+    TRACE("=== Starting Test 27: Waiting for several files ===");
+    group_passed = test_group_operations();
+    if (group_passed) {
+        printf("File group tests completed\n");
+    } else {
+        TRACE("File group tests failed");
+    }
+    TRACE("=== Test 27 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 28: Reading and writing without waiting (independent) */
+    TRACE("=== Starting Test 28: Reading and writing without waiting ===");
+    try_passed = test_try_operations();
+    if (try_passed) {
+        printf("Non-blocking read/write tests completed\n");
+    } else {
+        TRACE("Non-blocking read/write tests failed");
+    }
+    TRACE("=== Test 28 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 29: Opening many files ahead (independent) */
+    TRACE("=== Starting Test 29: Opening many files ahead ===");
+    batch_passed = test_batch_operations();
+    if (batch_passed) {
+        printf("Batch open tests completed\n");
+    } else {
+        TRACE("Batch open tests failed");
+    }
+    TRACE("=== Test 29 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 30: Block size cache (independent) */
+    TRACE("=== Starting Test 30: Block size cache ===");
+    geometry_passed = test_geometry_cache();
+    if (geometry_passed) {
+        printf("Block size cache tests completed\n");
+    } else {
+        TRACE("Block size cache tests failed");
+    }
+    TRACE("=== Test 30 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 31: Directory reading (independent) */
+    TRACE("=== Starting Test 31: Directory reading ===");
+    dir_passed = test_dir_operations();
+    if (dir_passed) {
+        printf("Directory tests completed\n");
+    } else {
+        TRACE("Directory tests failed");
+    }
+    TRACE("=== Test 31 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 32: Scheduling files on one device (independent) */
+    TRACE("=== Starting Test 32: Scheduling files on one device ===");
+    scheduler_passed = test_scheduler_operations();
+    if (scheduler_passed) {
+        printf("Scheduler tests completed\n");
+    } else {
+        TRACE("Scheduler tests failed");
+    }
+    TRACE("=== Test 32 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 33: Priorities and rate limits (independent) */
+    TRACE("=== Starting Test 33: Priorities and rate limits ===");
+    priority_passed = test_priority_operations();
+    if (priority_passed) {
+        printf("Priority tests completed\n");
+    } else {
+        TRACE("Priority tests failed");
+    }
+    TRACE("=== Test 33 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
+    /* Test 34: Scanning the ranges of a file side by side (independent) */
+    TRACE("=== Starting Test 34: Scanning ranges of a file ===");
+    scan_passed = test_scan_operations();
+    if (scan_passed) {
+        printf("Scan tests completed\n");
+    } else {
+        TRACE("Scan tests failed");
+    }
+    TRACE("=== Test 34 completed ===");
+    wait_for_async_operation(); /* Ensure cleanup between tests */
+
     /* Cleanup and summary */
     TRACE("Starting cleanup phase");
     cleanup_test_files();
@@ -1864,6 +2163,1844 @@ BOOL test_file_copy_validation(void)
     return TRUE;
 }
 
+/* Test ReadVAsync, WriteVAsync and WriteLinesAsync functions */
+BOOL test_vector_operations(void)
+{
+    struct AsyncFile *file;
+    struct AsyncIOVec vec[3];
+    LONG result;
+    LONG expected;
+    LONG lengths[8];
+    char header[16];
+    char body[3000];
+    char trailer[5];
+    char check[3000];
+    int i;
+
+    /* A small buffer makes the body element straddle several buffer flips */
+    for (i = 0; i < sizeof(body); i++) {
+        body[i] = (char)('A' + (i % 26));
+    }
+    memcpy(header, "ASYNCIO-VECTOR01", 16);
+    memcpy(trailer, "DONE\n", 5);
+
+    TEST_START("WriteVAsync - Write header, body and trailer in one call");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+
+    vec[0].iov_Base = header;
+    vec[0].iov_Len = sizeof(header);
+    vec[1].iov_Base = body;
+    vec[1].iov_Len = sizeof(body);
+    vec[2].iov_Base = trailer;
+    vec[2].iov_Len = sizeof(trailer);
+    expected = sizeof(header) + sizeof(body) + sizeof(trailer);
+
+    result = WriteVAsync(file, vec, 3);
+    TRACE2("WriteVAsync result: %ld (expected %ld)", result, expected);
+    TEST_ASSERT(result == expected, "WriteVAsync should write all elements");
+
+    for (i = 0; i < 8; i++) {
+        lengths[i] = strlen(test_strings[i]);
+    }
+    result = WriteLinesAsync(file, (STRPTR *)test_strings, lengths, 8);
+    TEST_ASSERT(result > 0, "WriteLinesAsync with lengths should succeed");
+    expected = result;
+
+    result = WriteLinesAsync(file, (STRPTR *)test_strings, NULL, 8);
+    TEST_ASSERT(result == expected, "WriteLinesAsync without lengths should write the same bytes");
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+    TEST_PASS();
+    wait_for_async_operation();
+
+    TEST_START("ReadVAsync - Scatter file back into separate buffers");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+
+    memset(header, 0, sizeof(header));
+    vec[0].iov_Base = header;
+    vec[0].iov_Len = sizeof(header);
+    vec[1].iov_Base = check;
+    vec[1].iov_Len = sizeof(check);
+    vec[2].iov_Base = trailer;
+    vec[2].iov_Len = sizeof(trailer);
+
+    result = ReadVAsync(file, vec, 3);
+    TRACE2("ReadVAsync result: %ld (expected %ld)", result, (LONG)(sizeof(header) + sizeof(check) + sizeof(trailer)));
+    TEST_ASSERT(result == sizeof(header) + sizeof(check) + sizeof(trailer), "ReadVAsync should fill all elements");
+    TEST_ASSERT(memcmp(header, "ASYNCIO-VECTOR01", 16) == 0, "Header should match");
+    TEST_ASSERT(memcmp(check, body, sizeof(body)) == 0, "Body should match");
+    TEST_ASSERT(memcmp(trailer, "DONE\n", 5) == 0, "Trailer should match");
+
+    for (i = 0; i < 16; i++) {
+        result = ReadLineAsync(file, check, MAX_LINE_LENGTH);
+        TEST_ASSERT(result > 0 && strcmp(check, test_strings[i % 8]) == 0, "Lines written by WriteLinesAsync should read back");
+    }
+
+    /* A short read at EOF returns what was available */
+    vec[0].iov_Base = check;
+    vec[0].iov_Len = 10;
+    result = ReadVAsync(file, vec, 1);
+    TEST_ASSERT(result == 0, "ReadVAsync at EOF should return 0");
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test FPrintfAsync and VFPrintfAsync functions */
+BOOL test_format_operations(void)
+{
+    struct AsyncFile *file;
+    LONG result;
+    LONG args[2];
+    char expected[MAX_LINE_LENGTH];
+    char buffer[MAX_LINE_LENGTH];
+    int i;
+
+    TEST_START("FPrintfAsync - Format lines straight into the write buffer");
+    /* A small buffer makes several lines straddle a buffer flip */
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+
+    for (i = 0; i < 200; i++) {
+        sprintf(expected, "Line %ld: %s", (long)i, test_strings[i % 8] + 4);
+        result = FPrintfAsync(file, (STRPTR)"Line %ld: %s", (LONG)i, test_strings[i % 8] + 4);
+        if (result != strlen(expected)) {
+            TRACE2("FPrintfAsync result: %ld (expected %ld)", result, (LONG)strlen(expected));
+            TEST_ASSERT(FALSE, "FPrintfAsync should return the number of characters written");
+        }
+    }
+
+    args[0] = 255;
+    args[1] = (LONG)"done";
+    result = VFPrintfAsync(file, (STRPTR)"%08lx %s\n", args);
+    TEST_ASSERT(result == 14, "VFPrintfAsync should return the number of characters written");
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+    wait_for_async_operation();
+
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+
+    for (i = 0; i < 200; i++) {
+        sprintf(expected, "Line %ld: %s", (long)i, test_strings[i % 8] + 4);
+        result = ReadLineAsync(file, buffer, MAX_LINE_LENGTH);
+        if (result <= 0 || strcmp(buffer, expected) != 0) {
+            printf("TRACE: Line %d mismatch: '%s' vs '%s'\n", i, buffer, expected);
+            TEST_ASSERT(FALSE, "Formatted lines should read back unchanged");
+        }
+    }
+
+    result = ReadLineAsync(file, buffer, MAX_LINE_LENGTH);
+    TEST_ASSERT(result == 14 && strcmp(buffer, "000000ff done\n") == 0, "VFPrintfAsync output should read back unchanged");
+
+    result = ReadLineAsync(file, buffer, MAX_LINE_LENGTH);
+    TEST_ASSERT(result == 0, "No null-terminators should have been written");
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+
+    /* NIL: drops a full buffer at once, null-terminator and all */
+    file = OpenAsync((STRPTR)"NIL:", MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for NIL:");
+    while (file->af_BytesLeft > 4) {
+        WriteCharAsync(file, 'x');
+    }
+    result = FPrintfAsync(file, (STRPTR)"%s", "abc");
+    TEST_ASSERT(result == 3, "FPrintfAsync should return the number of characters written");
+    TEST_ASSERT(file->af_BytesLeft <= file->af_BufferSize &&
+                file->af_Offset >= file->af_Buffers[file->af_CurrentBuf], "Filling the buffer of NIL: should leave it in bounds");
+    TEST_ASSERT(FPrintfAsync(file, (STRPTR)"%s", "more") == 4, "FPrintfAsync should go on working for NIL:");
+    TEST_ASSERT(CloseAsync(file) >= 0, "CloseAsync should succeed for NIL:");
+
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test ReadLongAsync and ReadLongsAsync functions */
+BOOL test_number_operations(void)
+{
+    struct AsyncFile *file;
+    LONG result;
+    LONG values[7];
+    LONG value;
+    LONG expected;
+    int i, j;
+
+    TEST_START("ReadLongsAsync - Parse columns of integers from the read buffer");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, TEST_BUFFER_SIZE);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+
+    /* 700 numbers, seven per line, mixing separators and signs */
+    for (i = 0; i < 100; i++) {
+        for (j = 0; j < 7; j++) {
+            FPrintfAsync(file, (STRPTR)(j < 6 ? "%ld,\t" : "%ld\n"), (LONG)((i * 7 + j) * 7919 - 500000));
+        }
+    }
+    FPrintfAsync(file, (STRPTR)"  +2147483647 -2147483648 007\r\n12 abc\n2147483648\n");
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+    wait_for_async_operation();
+
+    /* A small buffer makes numbers straddle buffer flips */
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+
+    for (i = 0; i < 100; i++) {
+        result = ReadLongsAsync(file, values, 7);
+        if (result != 7) {
+            TRACE2("ReadLongsAsync result: %ld at row %ld", result, (LONG)i);
+            TEST_ASSERT(FALSE, "ReadLongsAsync should read a full row");
+        }
+        for (j = 0; j < 7; j++) {
+            expected = (i * 7 + j) * 7919 - 500000;
+            if (values[j] != expected) {
+                TRACE2("Parsed %ld, expected %ld", values[j], expected);
+                TEST_ASSERT(FALSE, "Parsed values should match the written ones");
+            }
+        }
+    }
+
+    result = ReadLongsAsync(file, values, 3);
+    TEST_ASSERT(result == 3 && values[0] == 2147483647 && values[1] == (-2147483647 - 1) && values[2] == 7,
+        "Extreme values and leading zeros should parse");
+
+    result = ReadLongsAsync(file, values, 7);
+    TEST_ASSERT(result == 1 && values[0] == 12, "ReadLongsAsync should stop before text");
+
+    result = ReadLongAsync(file, &value);
+    TEST_ASSERT(result == -1 && IoErr() == ERROR_BAD_NUMBER, "ReadLongAsync should fail on text");
+
+    result = ReadAsync(file, values, 3);
+    TEST_ASSERT(result == 3 && memcmp(values, "abc", 3) == 0, "Offending text should be left unread");
+
+    result = ReadLongAsync(file, &value);
+    TEST_ASSERT(result == -1 && IoErr() == ERROR_BAD_NUMBER, "ReadLongAsync should fail on overflow");
+
+    while (ReadCharAsync(file) == '8') {
+    }
+    result = ReadLongAsync(file, &value);
+    TEST_ASSERT(result == 0, "ReadLongAsync should return 0 at EOF");
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test ReadEndianAsync and WriteEndianAsync functions */
+BOOL test_endian_operations(void)
+{
+    struct AsyncFile *file;
+    LONG result;
+    static UWORD words[600];
+    static ULONG longs[400];
+    static UBYTE quads[2][8];
+    UBYTE raw[8];
+    UBYTE quad[8];
+    UWORD word;
+    ULONG value;
+    int i;
+
+    for (i = 0; i < 600; i++) {
+        words[i] = (UWORD)(i * 257);
+    }
+    for (i = 0; i < 400; i++) {
+        longs[i] = (ULONG)i * 0x01020304;
+    }
+    for (i = 0; i < 16; i++) {
+        quads[i / 8][i % 8] = (UBYTE)(i + 1);
+    }
+
+    TEST_START("WriteEndianAsync - Write byte-swapped arrays across buffer flips");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+
+    /* An odd byte first, so elements straddle the buffer boundaries */
+    WriteCharAsync(file, 'X');
+    result = WriteBE16ArrayAsync(file, words, 600);
+    TEST_ASSERT(result == 600, "WriteBE16ArrayAsync should write all elements");
+    result = WriteLE32ArrayAsync(file, longs, 400);
+    TEST_ASSERT(result == 400, "WriteLE32ArrayAsync should write all elements");
+    result = WriteLE64ArrayAsync(file, quads, 2);
+    TEST_ASSERT(result == 2, "WriteLE64ArrayAsync should write all elements");
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+    TEST_PASS();
+    wait_for_async_operation();
+
+    TEST_START("ReadEndianAsync - Check byte order and read arrays back");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+
+    TEST_ASSERT(ReadCharAsync(file) == 'X', "Leading byte should be intact");
+    result = ReadAsync(file, raw, 2);
+    TEST_ASSERT(result == 2 && raw[0] == 0 && raw[1] == 0, "First word should be zero");
+    result = ReadAsync(file, raw, 2);
+    TEST_ASSERT(result == 2 && raw[0] == 1 && raw[1] == 1, "Second word should be stored big-endian");
+    result = ReadBE16Async(file, &word);
+    TEST_ASSERT(result == 1 && word == 2 * 257, "ReadBE16Async should convert a single value");
+
+    memset(words, 0, sizeof(words));
+    result = ReadBE16ArrayAsync(file, words + 3, 597);
+    TEST_ASSERT(result == 597, "ReadBE16ArrayAsync should read all elements");
+    for (i = 3; i < 600; i++) {
+        if (words[i] != (UWORD)(i * 257)) {
+            TEST_ASSERT(FALSE, "16 bit values should read back unchanged");
+        }
+    }
+
+    result = ReadAsync(file, raw, 8);
+    TEST_ASSERT(result == 8 && raw[4] == 4 && raw[5] == 3 && raw[6] == 2 && raw[7] == 1,
+        "32 bit values should be stored little-endian");
+    result = ReadLE32Async(file, &value);
+    TEST_ASSERT(result == 1 && value == 2 * 0x01020304, "ReadLE32Async should convert a single value");
+
+    memset(longs, 0, sizeof(longs));
+    result = ReadLE32ArrayAsync(file, longs + 3, 397);
+    TEST_ASSERT(result == 397, "ReadLE32ArrayAsync should read all elements");
+    for (i = 3; i < 400; i++) {
+        if (longs[i] != (ULONG)i * 0x01020304) {
+            TEST_ASSERT(FALSE, "32 bit values should read back unchanged");
+        }
+    }
+
+    result = ReadLE64Async(file, quad);
+    TEST_ASSERT(result == 1 && memcmp(quad, quads[0], 8) == 0, "64 bit values should read back unchanged");
+
+    /* Only half an element is left after this */
+    result = ReadAsync(file, raw, 4);
+    result = ReadLE64ArrayAsync(file, quad, 1);
+    TEST_ASSERT(result == 0, "A partial element at EOF should not be counted");
+
+    /* Element sizes other than 1, 2, 4 and 8 are refused */
+    result = ReadEndianAsync(file, quad, 1, AEF_LITTLE);
+    TEST_ASSERT(result == -1 && IoErr() == ERROR_BAD_NUMBER, "ReadEndianAsync should refuse elements of size 0");
+    result = ReadEndianAsync(file, quad, 1, 3);
+    TEST_ASSERT(result == -1 && IoErr() == ERROR_BAD_NUMBER, "ReadEndianAsync should refuse elements of size 3");
+    result = WriteEndianAsync(file, quad, 1, 0);
+    TEST_ASSERT(result == -1 && IoErr() == ERROR_BAD_NUMBER, "WriteEndianAsync should refuse elements of size 0");
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test bit and varint reading and writing functions */
+BOOL test_bit_operations(void)
+{
+    struct AsyncFile *file;
+    LONG result;
+    LONG bits;
+    ULONG value;
+    ULONG pattern;
+    static const ULONG varints[] = { 0, 1, 127, 128, 300, 16383, 16384, 0x7fffffff, 0xffffffff };
+    int i;
+
+    TEST_START("WriteBitsAsync/WriteVarIntAsync - Write a packed bitstream");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+
+    /* Every width from 1 to 24 bits, in a stream that spans several buffers */
+    pattern = 0x9e3779b9;
+    for (i = 0; i < 1000; i++) {
+        bits = 1 + (i % 24);
+        result = WriteBitsAsync(file, pattern >> (32 - bits), bits);
+        if (result != bits) {
+            TEST_ASSERT(FALSE, "WriteBitsAsync should write all bits");
+        }
+        pattern = pattern * 1103515245 + 12345;
+    }
+    TEST_ASSERT(AlignBitsAsync(file) == 0, "AlignBitsAsync should pad the last byte");
+
+    for (i = 0; i < 9; i++) {
+        result = WriteVarIntAsync(file, varints[i]);
+        if (result <= 0) {
+            TEST_ASSERT(FALSE, "WriteVarIntAsync should succeed");
+        }
+    }
+    TEST_ASSERT(WriteVarIntAsync(file, 300) == 2, "300 should take two bytes as a varint");
+
+    /* Left for CloseAsync() to pad out */
+    WriteBitsAsync(file, 5, 3);
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+    TEST_PASS();
+    wait_for_async_operation();
+
+    TEST_START("ReadBitsAsync/ReadVarIntAsync - Read the bitstream back");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+
+    pattern = 0x9e3779b9;
+    for (i = 0; i < 1000; i++) {
+        bits = 1 + (i % 24);
+        if (i % 3 == 0) {
+            result = PeekBitsAsync(file, bits);
+            if (result != (LONG)(pattern >> (32 - bits))) {
+                TRACE2("PeekBitsAsync returned %ld at %ld", result, (LONG)i);
+                TEST_ASSERT(FALSE, "PeekBitsAsync should not consume bits");
+            }
+        }
+        result = ReadBitsAsync(file, bits);
+        if (result != (LONG)(pattern >> (32 - bits))) {
+            TRACE2("ReadBitsAsync returned %ld at %ld", result, (LONG)i);
+            TEST_ASSERT(FALSE, "ReadBitsAsync should return the written bits");
+        }
+        pattern = pattern * 1103515245 + 12345;
+    }
+    TEST_ASSERT(AlignBitsAsync(file) == 0, "AlignBitsAsync should skip the padding");
+
+    for (i = 0; i < 9; i++) {
+        result = ReadVarIntAsync(file, &value);
+        if (result <= 0 || value != varints[i]) {
+            TRACE2("ReadVarIntAsync returned %ld, value %lu", result, value);
+            TEST_ASSERT(FALSE, "Varints should read back unchanged");
+        }
+    }
+    result = ReadVarIntAsync(file, &value);
+    TEST_ASSERT(result == 2 && value == 300, "ReadVarIntAsync should return the bytes consumed");
+
+    result = PeekBitsAsync(file, 16);
+    TEST_ASSERT(result == 0xa000, "PeekBitsAsync should pad with zeros at EOF");
+    result = ReadBitsAsync(file, 3);
+    TEST_ASSERT(result == 5, "CloseAsync should have flushed pending bits");
+    result = ReadBitsAsync(file, 8);
+    TEST_ASSERT(result == 0, "ReadBitsAsync should pad with zeros at EOF, like PeekBitsAsync");
+    result = ReadBitsAsync(file, 1);
+    TEST_ASSERT(result == -1, "ReadBitsAsync should fail at EOF");
+    result = ReadVarIntAsync(file, &value);
+    TEST_ASSERT(result == 0, "ReadVarIntAsync should return 0 at EOF");
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+
+    /* A peek across a buffer flip takes bytes out of the byte stream,
+     * which AlignBitsAsync must give back
+     */
+    file = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+    for (i = 0; i < 2000; i++) {
+        WriteCharAsync(file, (UBYTE)(i % 251));
+    }
+    CloseAsync(file);
+
+    file = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+    ReadCharAsync(file);
+    bits = file->af_BytesLeft - 1;
+    for (i = 1; i < bits; i++) {
+        ReadCharAsync(file);
+    }
+    result = PeekBitsAsync(file, 24);
+    TEST_ASSERT(result == (((bits % 251) << 16) | (((bits + 1) % 251) << 8) | ((bits + 2) % 251)), "PeekBitsAsync should look across the buffer flip");
+    TEST_ASSERT(AlignBitsAsync(file) == 0, "AlignBitsAsync should succeed after a peek across buffers");
+    TEST_ASSERT(ReadCharAsync(file) == bits % 251, "The peeked bytes should go back to the byte stream");
+    TEST_ASSERT(ReadCharAsync(file) == (bits + 1) % 251, "The peeked bytes should be read in order");
+    TEST_ASSERT(ReadCharAsync(file) == (bits + 2) % 251, "The byte stream should carry on in the next buffer");
+    CloseAsync(file);
+    DeleteFile(TEST_FILE_NAME2);
+
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test ASYNC_GETC and ASYNC_PUTC macros */
+BOOL test_inline_char_operations(void)
+{
+    struct AsyncFile *file;
+    LONG result;
+    LONG ch;
+    int i;
+
+    TEST_START("ASYNC_PUTC/ASYNC_GETC - Byte at a time through the buffers");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+
+    /* 5000 bytes through a 1024 byte buffer pair means several flips */
+    for (i = 0; i < 5000; i++) {
+        if (ASYNC_PUTC(file, (UBYTE)(i * 7)) != 1) {
+            TEST_ASSERT(FALSE, "ASYNC_PUTC should return 1");
+        }
+    }
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+    wait_for_async_operation();
+
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+
+    for (i = 0; i < 5000; i++) {
+        ch = ASYNC_GETC(file);
+        if (ch != (UBYTE)(i * 7)) {
+            TRACE2("ASYNC_GETC returned %ld at %ld", ch, (LONG)i);
+            TEST_ASSERT(FALSE, "ASYNC_GETC should return the written bytes");
+        }
+    }
+    TEST_ASSERT(ASYNC_GETC(file) == -1, "ASYNC_GETC should return -1 at EOF");
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test CopyAsync function */
+BOOL test_copy_operations(void)
+{
+    struct AsyncFile *src;
+    struct AsyncFile *dst;
+    LONG result;
+    LONG ch;
+    int i;
+
+    TEST_START("CopyAsync - Copy between files with different buffer sizes");
+    src = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, TEST_BUFFER_SIZE);
+    TEST_ASSERT(src != NULL, "OpenAsync should succeed for the source");
+    for (i = 0; i < 20000; i++) {
+        ASYNC_PUTC(src, (UBYTE)(i % 251));
+    }
+    result = CloseAsync(src);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed for the source");
+    wait_for_async_operation();
+
+    src = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 2048);
+    TEST_ASSERT(src != NULL, "OpenAsync should succeed for reading the source");
+    dst = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_WRITE, 1024);
+    TEST_ASSERT(dst != NULL, "OpenAsync should succeed for the destination");
+
+    /* A partial copy, some bytes by hand, and the rest up to EOF */
+    result = CopyAsync(src, dst, 100);
+    TEST_ASSERT(result == 100, "CopyAsync should copy the requested length");
+    for (i = 100; i < 150; i++) {
+        ASYNC_PUTC(dst, (UBYTE)ASYNC_GETC(src));
+    }
+    result = CopyAsync(src, dst, -1);
+    TEST_ASSERT(result == 20000 - 150, "CopyAsync with -1 should copy up to EOF");
+    result = CopyAsync(src, dst, 10);
+    TEST_ASSERT(result == 0, "CopyAsync at EOF should copy nothing");
+
+    TEST_ASSERT(CloseAsync(src) >= 0, "CloseAsync should succeed for the source");
+    TEST_ASSERT(CloseAsync(dst) >= 0, "CloseAsync should succeed for the destination");
+    wait_for_async_operation();
+
+    dst = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_READ, TEST_BUFFER_SIZE);
+    TEST_ASSERT(dst != NULL, "OpenAsync should succeed for reading the copy");
+    for (i = 0; i < 20000; i++) {
+        ch = ASYNC_GETC(dst);
+        if (ch != i % 251) {
+            TRACE2("Copy has %ld at %ld", ch, (LONG)i);
+            TEST_ASSERT(FALSE, "Copy should match the source");
+        }
+    }
+    TEST_ASSERT(ASYNC_GETC(dst) == -1, "Copy should have the same length as the source");
+    TEST_ASSERT(CloseAsync(dst) >= 0, "CloseAsync should succeed for the copy");
+
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test TeeAsync function */
+BOOL test_tee_operations(void)
+{
+    struct AsyncFile *file;
+    BPTR mirror;
+    LONG result;
+    LONG ch1, ch2;
+    struct AsyncFile *copy1;
+    struct AsyncFile *copy2;
+    int i;
+
+    TEST_START("TeeAsync - Write one stream to two files");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+    mirror = Open((STRPTR)TEST_FILE_NAME2, MODE_NEWFILE);
+    TEST_ASSERT(mirror != 0, "Open should succeed for the mirror");
+
+    result = TeeAsync(file, mirror);
+    TEST_ASSERT(result == 0, "TeeAsync should succeed on a fresh file");
+
+    for (i = 0; i < 20000; i++) {
+        ASYNC_PUTC(file, (UBYTE)(i % 253));
+    }
+
+    /* Seeking keeps both files in step */
+    result = SeekAsync(file, 0, MODE_START);
+    TEST_ASSERT(result >= 0, "SeekAsync should succeed");
+    result = WriteAsync(file, "HEAD", 4);
+    TEST_ASSERT(result == 4, "WriteAsync after seek should succeed");
+
+    result = TeeAsync(file, mirror);
+    TEST_ASSERT(result == -1 && IoErr() == ERROR_OBJECT_IN_USE, "TeeAsync should fail with data in the buffer");
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+
+    /* Neither of these has buffers of its own data to share */
+    file = OpenAsync((STRPTR)"NIL:", MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed on NIL:");
+    result = TeeAsync(file, mirror);
+    TEST_ASSERT(result == -1 && IoErr() == ERROR_OBJECT_WRONG_TYPE, "TeeAsync should fail on NIL:");
+    CloseAsync(file);
+
+    file = OpenAsync((STRPTR)"T:asyncio_tee.dat", MODE_WRITE | MODEF_COMPRESSED, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed in compressed mode");
+    result = TeeAsync(file, mirror);
+    TEST_ASSERT(result == -1 && IoErr() == ERROR_OBJECT_WRONG_TYPE, "TeeAsync should fail on a compressed file");
+    CloseAsync(file);
+    DeleteFile((STRPTR)"T:asyncio_tee.dat");
+
+    Close(mirror);
+    wait_for_async_operation();
+
+    copy1 = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, TEST_BUFFER_SIZE);
+    copy2 = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_READ, TEST_BUFFER_SIZE);
+    TEST_ASSERT(copy1 != NULL && copy2 != NULL, "Both files should open for reading");
+
+    for (i = 0; i < 20000; i++) {
+        ch1 = ASYNC_GETC(copy1);
+        ch2 = ASYNC_GETC(copy2);
+        if (ch1 != ch2 || ch1 != (i < 4 ? "HEAD"[i] : i % 253)) {
+            TRACE2("Files differ at %ld (%ld)", (LONG)i, ch1);
+            TEST_ASSERT(FALSE, "Both files should have the same content");
+        }
+    }
+    TEST_ASSERT(ASYNC_GETC(copy1) == -1 && ASYNC_GETC(copy2) == -1, "Both files should have the same length");
+
+    CloseAsync(copy1);
+    CloseAsync(copy2);
+
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test streaming digests */
+BOOL test_digest_operations(void)
+{
+    struct AsyncFile *file;
+    LONG result;
+    ULONG digest[2];
+    UBYTE buffer[300];
+    int i;
+
+    TEST_START("SetDigestAsync/GetDigestAsync - Digests across buffer flips");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+
+    TEST_ASSERT(GetDigestAsync(file, digest) == 0, "GetDigestAsync should return 0 without a digest");
+    result = SetDigestAsync(file, 99);
+    TEST_ASSERT(result == -1 && IoErr() == ERROR_NOT_IMPLEMENTED, "SetDigestAsync should reject unknown types");
+    result = SetDigestAsync(file, DIGEST_CRC32);
+    TEST_ASSERT(result == 0, "SetDigestAsync should succeed");
+
+    /* The macro writes straight into the buffer, behind the library's back */
+    for (i = 0; i < 20000; i++) {
+        ASYNC_PUTC(file, (UBYTE)(i % 253));
+    }
+
+    result = GetDigestAsync(file, digest);
+    TEST_ASSERT(result == 4, "CRC-32 should be 4 bytes");
+    TRACE2("CRC-32 of written data: %08lx (%ld)", digest[0], result);
+    TEST_ASSERT(digest[0] == 0x0c608855, "CRC-32 of written data should match");
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+    TEST_PASS();
+
+    TEST_START("SetDigestAsync - Read digests and seeking");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+    SetDigestAsync(file, DIGEST_ADLER32);
+
+    while ((result = ReadAsync(file, buffer, sizeof(buffer))) > 0) {
+    }
+    TEST_ASSERT(result == 0, "ReadAsync should reach EOF");
+    GetDigestAsync(file, digest);
+    TEST_ASSERT(digest[0] == 0xc2376fe3, "Adler-32 of read data should match");
+
+    /* The digest starts over at the position of the seek */
+    result = SeekAsync(file, 4, MODE_START);
+    TEST_ASSERT(result >= 0, "SeekAsync should succeed");
+    SetDigestAsync(file, DIGEST_FNV64);
+
+    while (ASYNC_GETC(file) >= 0) {
+    }
+    result = GetDigestAsync(file, digest);
+    TEST_ASSERT(result == 8, "FNV-1a should be 8 bytes");
+    TEST_ASSERT(digest[0] == 0x31679e9c && digest[1] == 0xa5134de9, "FNV-1a of read data should match");
+
+    CloseAsync(file);
+    TEST_PASS();
+
+    TEST_START("GetDigestAsync - Catch up before the buffer flips");
+    file = OpenAsync((STRPTR)"T:asyncio_crc", MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+    SetDigestAsync(file, DIGEST_CRC32);
+    result = WriteAsync(file, "123456789", 9);
+    TEST_ASSERT(result == 9, "WriteAsync should succeed");
+
+    /* Nothing has been sent yet, so all of it is still in the buffer */
+    result = GetDigestAsync(file, digest);
+    TEST_ASSERT(result == 4, "CRC-32 should be 4 bytes");
+    TEST_ASSERT(digest[0] == 0xcbf43926, "CRC-32 of the check string should match");
+
+    CloseAsync(file);
+    DeleteFile("T:asyncio_crc");
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test compressed files */
+BOOL test_compressed_operations(void)
+{
+    struct AsyncFile *file;
+    LONG result;
+    LONG packedSize;
+    ULONG seed;
+    UBYTE buffer[256];
+    int i;
+
+    TEST_START("MODEF_COMPRESSED - Write and read back a compressed file");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE | MODEF_COMPRESSED, TEST_BUFFER_SIZE);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed in compressed mode");
+
+    /* Text that compresses well, then noise that doesn't */
+    for (i = 0; i < 5000; i++) {
+        if (FPrintfAsync(file, "Line %ld of the compressed test file\n", (LONG)i) <= 0) {
+            TEST_ASSERT(FALSE, "FPrintfAsync should succeed");
+        }
+    }
+    seed = 1;
+    for (i = 0; i < 50000; i++) {
+        seed = seed * 1103515245 + 12345;
+        ASYNC_PUTC(file, (UBYTE)(seed >> 16));
+    }
+
+    result = SeekAsync(file, 0, MODE_START);
+    TEST_ASSERT(result == -1 && IoErr() == ERROR_ACTION_NOT_KNOWN, "SeekAsync should fail on a compressed file");
+
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+
+    /* The file itself should be a lot smaller than the data */
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, TEST_BUFFER_SIZE);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed on the packed data");
+    packedSize = 0;
+    while ((result = ReadAsync(file, buffer, sizeof(buffer))) > 0) {
+        packedSize += result;
+    }
+    CloseAsync(file);
+    TRACE1("Compressed size: %ld", packedSize);
+    TEST_ASSERT(packedSize > 50000 && packedSize < 100000, "Text should have been compressed");
+
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ | MODEF_COMPRESSED, TEST_BUFFER_SIZE);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed in compressed mode for reading");
+
+    for (i = 0; i < 5000; i++) {
+        char expected[64];
+
+        sprintf(expected, "Line %ld of the compressed test file", (long)i);
+        result = ReadLineAsync(file, buffer, sizeof(buffer));
+        if (result > 0) {
+            buffer[result - 1] = 0;
+        }
+        if (result <= 0 || strcmp((char *)buffer, expected) != 0) {
+            TRACE2("Line %ld differs: %s", (LONG)i, buffer);
+            TEST_ASSERT(FALSE, "Text should read back unchanged");
+        }
+    }
+    seed = 1;
+    for (i = 0; i < 50000; i++) {
+        seed = seed * 1103515245 + 12345;
+        if (ASYNC_GETC(file) != (UBYTE)(seed >> 16)) {
+            TRACE1("Noise differs at %ld", (LONG)i);
+            TEST_ASSERT(FALSE, "Noise should read back unchanged");
+        }
+    }
+    TEST_ASSERT(ASYNC_GETC(file) == -1, "Compressed file should end with the data");
+    CloseAsync(file);
+    TEST_PASS();
+
+    TEST_START("MODEF_COMPRESSED - The same data compresses the same way");
+    for (i = 0; i < 2; i++) {
+        file = OpenAsync((STRPTR)(i ? TEST_FILE_NAME2 : TEST_FILE_NAME), MODE_WRITE | MODEF_COMPRESSED, TEST_BUFFER_SIZE);
+        TEST_ASSERT(file != NULL, "OpenAsync should succeed in compressed mode");
+        for (seed = 0; seed < 3000; seed++) {
+            FPrintfAsync(file, "Record %ld, %ld\n", (LONG)seed, (LONG)(seed % 17));
+        }
+        TEST_ASSERT(CloseAsync(file) >= 0, "CloseAsync should succeed");
+    }
+    {
+        struct AsyncFile *files[2];
+        UBYTE other[256];
+        LONG otherResult;
+
+        files[0] = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, TEST_BUFFER_SIZE);
+        files[1] = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_READ, TEST_BUFFER_SIZE);
+        TEST_ASSERT(files[0] != NULL && files[1] != NULL, "OpenAsync should succeed on the packed data");
+        do {
+            result = ReadAsync(files[0], buffer, sizeof(buffer));
+            otherResult = ReadAsync(files[1], other, sizeof(other));
+            if (result != otherResult || (result > 0 && memcmp(buffer, other, result) != 0)) {
+                TEST_ASSERT(FALSE, "Compressing the same data twice should give the same bytes");
+            }
+        } while (result > 0);
+        CloseAsync(files[0]);
+        CloseAsync(files[1]);
+    }
+    TEST_PASS();
+
+    TEST_START("MODEF_COMPRESSED - Matches after data that doesn't compress");
+    {
+        static UBYTE data[32768];
+        static const char text[] = "A line that comes back after noise, again and again.\n";
+        LONG noise, total;
+
+        /* One block: a long run of noise, which is skimmed, then the same
+         * text between short bits of noise, where each match has to be
+         * found soon after the noise
+         */
+        seed = 7;
+        total = 0;
+        noise = 0;
+        while (total < (LONG)sizeof(data)) {
+            if (total < 12000 || (total - 12000) % 240 >= 200) {
+                seed = seed * 1103515245 + 12345;
+                data[total] = (UBYTE)(seed >> 16);
+                noise++;
+            } else {
+                data[total] = text[((total - 12000) % 240) % (sizeof(text) - 1)];
+            }
+            total++;
+        }
+
+        file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE | MODEF_COMPRESSED, TEST_BUFFER_SIZE);
+        TEST_ASSERT(file != NULL, "OpenAsync should succeed in compressed mode");
+        TEST_ASSERT(WriteAsync(file, data, sizeof(data)) == sizeof(data), "WriteAsync should succeed");
+        TEST_ASSERT(CloseAsync(file) >= 0, "CloseAsync should succeed");
+
+        file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, TEST_BUFFER_SIZE);
+        TEST_ASSERT(file != NULL, "OpenAsync should succeed on the packed data");
+        packedSize = 0;
+        while ((result = ReadAsync(file, buffer, sizeof(buffer))) > 0) {
+            packedSize += result;
+        }
+        CloseAsync(file);
+        TRACE2("Compressed size: %ld, noise: %ld", packedSize, noise);
+        TEST_ASSERT(packedSize < noise + 1500, "The text between the noise should have been compressed");
+
+        file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ | MODEF_COMPRESSED, TEST_BUFFER_SIZE);
+        TEST_ASSERT(file != NULL, "OpenAsync should succeed in compressed mode for reading");
+        for (total = 0; total < (LONG)sizeof(data); total += result) {
+            result = ReadAsync(file, buffer, sizeof(buffer));
+            if (result <= 0 || memcmp(buffer, data + total, result) != 0) {
+                TRACE1("Data differs after %ld", total);
+                TEST_ASSERT(FALSE, "The data should read back unchanged");
+            }
+        }
+        TEST_ASSERT(ASYNC_GETC(file) == -1, "Compressed file should end with the data");
+        CloseAsync(file);
+    }
+    TEST_PASS();
+
+    TEST_START("MODEF_COMPRESSED - Reading a file that isn't compressed");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_WRITE, TEST_BUFFER_SIZE);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+    WriteAsync(file, "This is not a compressed file.", 30);
+    CloseAsync(file);
+
+    file = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_READ | MODEF_COMPRESSED, TEST_BUFFER_SIZE);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed in compressed mode for reading");
+    result = ReadAsync(file, buffer, sizeof(buffer));
+    TEST_ASSERT(result == -1 && IoErr() == ERROR_OBJECT_WRONG_TYPE, "ReadAsync should fail on bad data");
+    CloseAsync(file);
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test searching */
+BOOL test_find_operations(void)
+{
+    struct AsyncFile *file;
+    LONG result;
+    LONG ch;
+    int i;
+
+    TEST_START("FindAsync - Matches within and across buffers");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+
+    /* Markers around the buffer boundaries, with near misses before them */
+    for (i = 0; i < 8000; i++) {
+        if (i == 509 || i == 1535 || i == 6140) {
+            WriteAsync(file, "NEENeedle", 9);
+            i += 8;
+        } else {
+            ASYNC_PUTC(file, (UBYTE)('a' + i % 13));
+        }
+    }
+    CloseAsync(file);
+
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+
+    result = FindAsync(file, "NEEDLE", 6, FINDF_NOCASE);
+    TRACE1("First match after %ld bytes", result);
+    TEST_ASSERT(result == 512, "First match should be found");
+    ch = ReadCharAsync(file);
+    TEST_ASSERT(ch == 'a' + 518 % 13, "File should be positioned after the match");
+
+    result = FindAsync(file, "Needle", 6, 0);
+    TEST_ASSERT(result == 1538 - 519, "Second match should be found");
+    result = FindAsync(file, "NEEDLE", 6, FINDF_NOCASE);
+    TEST_ASSERT(result == 6143 - 1544, "Third match should be found");
+
+    result = FindAsync(file, "Needle", 6, 0);
+    TEST_ASSERT(result == -1 && IoErr() == ERROR_OBJECT_NOT_FOUND, "FindAsync should report no more matches");
+    TEST_ASSERT(ReadCharAsync(file) == -1, "File should be at EOF after a failed search");
+
+    result = FindAsync(file, "", 0, 0);
+    TEST_ASSERT(result == -1, "FindAsync should reject an empty pattern");
+    CloseAsync(file);
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test line counting */
+BOOL test_count_lines(void)
+{
+    struct AsyncFile *file;
+    LONG result;
+    ULONG lines, longest;
+    int i;
+
+    TEST_START("CountLinesAsync - Count lines across buffers");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+
+    /* Line i is i % 100 characters long, plus the newline */
+    for (i = 0; i < 1000; i++) {
+        int j;
+
+        for (j = 0; j < i % 100; j++) {
+            ASYNC_PUTC(file, 'x');
+        }
+        ASYNC_PUTC(file, '\n');
+    }
+    WriteAsync(file, "no newline", 10);
+    CloseAsync(file);
+
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+    result = CountLinesAsync(file, -1, &lines, &longest);
+    TRACE2("Counted %ld lines, longest %ld", (LONG)lines, (LONG)longest);
+    TEST_ASSERT(result == 50500 + 10, "All bytes should be scanned");
+    TEST_ASSERT(lines == 1001, "All lines should be counted");
+    TEST_ASSERT(longest == 100, "Longest line should include its newline");
+    TEST_ASSERT(ReadCharAsync(file) == -1, "File should be at EOF");
+
+    /* Count the first part only, and without line lengths */
+    result = SeekAsync(file, 0, MODE_START);
+    TEST_ASSERT(result >= 0, "SeekAsync should succeed");
+    result = CountLinesAsync(file, 1280, &lines, NULL);
+    TEST_ASSERT(result == 1280 && lines == 51, "Counting should stop at the limit");
+    TEST_ASSERT(ReadCharAsync(file) == 'x', "File should be positioned at the limit");
+
+    CloseAsync(file);
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test the line index */
+BOOL test_line_index(void)
+{
+    struct AsyncFile *file;
+    struct AsyncFile *indexFile;
+    struct AsyncLineIndex *index;
+    struct AsyncLineIndex *loaded;
+    char line[64];
+    LONG result;
+    int i;
+
+    TEST_START("BuildLineIndexAsync/ReadLineAtAsync - Random line access");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+    for (i = 0; i < 1000; i++) {
+        FPrintfAsync(file, "Line %ld\n", (LONG)i);
+    }
+    WriteAsync(file, "Tail", 4);
+    CloseAsync(file);
+
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+    indexFile = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_WRITE, 1024);
+    TEST_ASSERT(indexFile != NULL, "OpenAsync should succeed for the index");
+
+    index = BuildLineIndexAsync(file, 16, indexFile);
+    TEST_ASSERT(index != NULL, "BuildLineIndexAsync should succeed");
+    CloseAsync(indexFile);
+    TRACE2("Index of %ld lines, %ld offsets", (LONG)index->ali_Lines, (LONG)index->ali_Count);
+    TEST_ASSERT(index->ali_Lines == 1001 && index->ali_Count == 63, "Index should cover all lines");
+
+    indexFile = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_READ, 1024);
+    TEST_ASSERT(indexFile != NULL, "OpenAsync should succeed for the saved index");
+    loaded = LoadLineIndexAsync(indexFile);
+    CloseAsync(indexFile);
+    TEST_ASSERT(loaded != NULL, "LoadLineIndexAsync should succeed");
+    TEST_ASSERT(loaded->ali_Lines == index->ali_Lines && loaded->ali_Count == index->ali_Count &&
+                memcmp(loaded->ali_Offsets, index->ali_Offsets, index->ali_Count * sizeof(LONG)) == 0,
+                "Loaded index should match the built one");
+
+    for (i = 999; i >= 0; i -= 37) {
+        char expected[64];
+
+        sprintf(expected, "Line %ld\n", (long)i);
+        result = ReadLineAtAsync(file, loaded, i, line, sizeof(line));
+        if (result <= 0 || strcmp(line, expected) != 0) {
+            TRACE2("Line %ld read as %s", (LONG)i, line);
+            TEST_ASSERT(FALSE, "ReadLineAtAsync should return the right line");
+        }
+    }
+
+    result = ReadLineAtAsync(file, loaded, 1000, line, sizeof(line));
+    TEST_ASSERT(result == 4 && strcmp(line, "Tail") == 0, "Last line should be readable");
+    result = ReadLineAtAsync(file, loaded, 1001, line, sizeof(line));
+    TEST_ASSERT(result == 0, "Reading past the last line should return 0");
+
+    FreeVec(index);
+    FreeVec(loaded);
+    CloseAsync(file);
+    TEST_PASS();
+
+    TEST_START("LoadLineIndexAsync - Corrupted headers are refused");
+    {
+        static const ULONG headers[3][4] = {
+            { 0x414c4958, 1, 0x40000001, 0x40000001 },  /* too many offsets */
+            { 0x414c4958, 16, 5000, 63 },               /* more lines than offsets */
+            { 0x414c4958, 16, 0, 2 }                    /* empty, with two offsets */
+        };
+        static const ULONG offsets[63];
+
+        for (i = 0; i < 3; i++) {
+            indexFile = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_WRITE, 1024);
+            TEST_ASSERT(indexFile != NULL, "OpenAsync should succeed for the index");
+            WriteBE32ArrayAsync(indexFile, (APTR)headers[i], 4);
+            WriteBE32ArrayAsync(indexFile, (APTR)offsets, 63);
+            CloseAsync(indexFile);
+
+            indexFile = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_READ, 1024);
+            TEST_ASSERT(indexFile != NULL, "OpenAsync should succeed for the index");
+            loaded = LoadLineIndexAsync(indexFile);
+            result = IoErr();
+            CloseAsync(indexFile);
+            if (loaded != NULL || result != ERROR_OBJECT_WRONG_TYPE) {
+                TRACE1("Header %ld was accepted", (LONG)i);
+                TEST_ASSERT(FALSE, "LoadLineIndexAsync should refuse a corrupted header");
+                FreeVec(loaded);
+            }
+        }
+    }
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test in-place buffer access */
+BOOL test_in_place_operations(void)
+{
+    struct AsyncFile *file;
+    APTR ptr;
+    UBYTE *p;
+    LONG result;
+    LONG total;
+    int i;
+
+    TEST_START("ReadInPlaceAsync/WriteInPlaceAsync - Use the buffers directly");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed");
+
+    for (total = 0; total < 30000; total += result) {
+        result = WriteInPlaceAsync(file, &ptr, 30000 - total < 700 ? 30000 - total : 700);
+        if (result <= 0) {
+            TEST_ASSERT(FALSE, "WriteInPlaceAsync should give some space");
+        }
+        p = ptr;
+        for (i = 0; i < result; i++) {
+            p[i] = (UBYTE)((total + i) % 251);
+        }
+    }
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+
+    total = 0;
+    while ((result = ReadInPlaceAsync(file, &ptr, -1)) > 0) {
+        p = ptr;
+        for (i = 0; i < result; i++) {
+            if (p[i] != (UBYTE)((total + i) % 251)) {
+                TRACE1("Data differs at %ld", total + i);
+                TEST_ASSERT(FALSE, "Data should read back unchanged");
+            }
+        }
+        total += result;
+    }
+    TEST_ASSERT(result == 0, "ReadInPlaceAsync should end with EOF");
+    TEST_ASSERT(total == 30000, "All data should be read");
+
+    /* It works together with the normal functions */
+    SeekAsync(file, 100, MODE_START);
+    result = ReadInPlaceAsync(file, &ptr, 10);
+    TEST_ASSERT(result == 10 && *(UBYTE *)ptr == 100, "ReadInPlaceAsync should return at most numBytes");
+    TEST_ASSERT(ReadCharAsync(file) == 110, "Reading should go on after the bytes returned");
+    CloseAsync(file);
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test MODEF_DIRECT */
+BOOL test_direct_operations(void)
+{
+    struct AsyncFile *file;
+    UBYTE buffer[3000];
+    LONG result;
+    LONG c;
+    int i;
+
+    TEST_START("MODEF_DIRECT - Aligned buffers and seeks while writing");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE | MODEF_DIRECT, 2048);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed with MODEF_DIRECT");
+    TEST_ASSERT(((ULONG)file->af_Buffers[0] & (file->af_BlockSize - 1)) == 0, "Buffers should be aligned on the blocks");
+
+    for (i = 0; i < 3000; i++) {
+        buffer[i] = (UBYTE)(i % 251);
+    }
+    result = WriteAsync(file, buffer, 3000);
+    TEST_ASSERT(result == 3000, "WriteAsync should succeed");
+
+    /* overwrite part of it, from the middle of a block */
+    result = SeekAsync(file, 1000, MODE_START);
+    TEST_ASSERT(result >= 0, "SeekAsync should succeed");
+    for (i = 0; i < 3000; i++) {
+        buffer[i] = (UBYTE)(i % 13);
+    }
+    result = WriteAsync(file, buffer, 3000);
+    TEST_ASSERT(result == 3000, "WriteAsync after SeekAsync should succeed");
+    result = SeekAsync(file, 0, MODE_CURRENT);
+    TEST_ASSERT(result == 4000, "SeekAsync should give the position");
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+
+    /* append from the middle of a block too */
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_APPEND | MODEF_DIRECT, 2048);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed in MODE_APPEND");
+    result = WriteAsync(file, buffer, 3000);
+    TEST_ASSERT(result == 3000, "WriteAsync should succeed when appending");
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ | MODEF_DIRECT, 2048);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+    for (i = 0; i < 7000; i++) {
+        c = ReadCharAsync(file);
+        if (c != (i < 1000 ? i % 251 : i < 4000 ? (i - 1000) % 13 : (i - 4000) % 13)) {
+            TRACE2("Byte %ld is %ld", (LONG)i, c);
+            TEST_ASSERT(FALSE, "The file should hold what was written");
+        }
+    }
+    TEST_ASSERT(ReadCharAsync(file) == -1, "The file should end after the data");
+    CloseAsync(file);
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test CreateAsyncGroup, AttachAsync, WaitAnyAsync and PollAsync */
+BOOL test_group_operations(void)
+{
+    struct AsyncGroup *group;
+    struct AsyncFile *files[2];
+    struct AsyncFile *file;
+    LONG totals[2];
+    LONG sizes[2];
+    LONG result;
+    APTR ptr;
+    int open_files;
+    int i, j;
+
+    TEST_START("WaitAnyAsync - Read two files as their data arrives");
+    sizes[0] = 5000;
+    sizes[1] = 9000;
+    for (i = 0; i < 2; i++) {
+        file = OpenAsync((STRPTR)(i ? TEST_FILE_NAME2 : TEST_FILE_NAME), MODE_WRITE, 1024);
+        TEST_ASSERT(file != NULL, "OpenAsync should succeed for writing");
+        for (j = 0; j < sizes[i]; j++) {
+            WriteCharAsync(file, (UBYTE)(j % 97));
+        }
+        CloseAsync(file);
+    }
+
+    group = CreateAsyncGroup();
+    TEST_ASSERT(group != NULL, "CreateAsyncGroup should succeed");
+    TEST_ASSERT(group->ag_SignalMask != 0, "The group should have a signal");
+    TEST_ASSERT(PollAsync(group) == NULL, "PollAsync should find nothing in an empty group");
+
+    for (i = 0; i < 2; i++) {
+        files[i] = OpenAsync((STRPTR)(i ? TEST_FILE_NAME2 : TEST_FILE_NAME), MODE_READ, 1024);
+        TEST_ASSERT(files[i] != NULL, "OpenAsync should succeed for reading");
+        AttachAsync(files[i], group);
+        totals[i] = 0;
+    }
+
+    open_files = 2;
+    while ((file = WaitAnyAsync(group)) != NULL) {
+        i = (file == files[1]);
+        if (file != files[i]) {
+            TEST_ASSERT(FALSE, "WaitAnyAsync should return a file in the group");
+        }
+
+        /* a ready file can be read without waiting */
+        result = ReadInPlaceAsync(file, &ptr, -1);
+        if (result < 0) {
+            TEST_ASSERT(FALSE, "ReadInPlaceAsync should succeed");
+        }
+        for (j = 0; j < result; j++) {
+            if (((UBYTE *)ptr)[j] != (UBYTE)((totals[i] + j) % 97)) {
+                TRACE2("File %ld differs at %ld", (LONG)i, totals[i] + j);
+                TEST_ASSERT(FALSE, "Data should be read in order");
+            }
+        }
+        totals[i] += result;
+
+        if (result == 0) {
+            AttachAsync(file, NULL);
+            open_files--;
+        }
+    }
+    TEST_ASSERT(open_files == 0, "WaitAnyAsync should return NULL once the group is empty");
+    TEST_ASSERT(totals[0] == sizes[0] && totals[1] == sizes[1], "All data should be read from both files");
+
+    /* a file being written is ready when there is room */
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for writing");
+    AttachAsync(file, group);
+    TEST_ASSERT(PollAsync(group) == file, "PollAsync should return a file with room");
+    for (j = 0; j < 3000; j++) {
+        WriteCharAsync(file, 'x');
+    }
+
+    /* closing a file takes it out of its group */
+    CloseAsync(file);
+    CloseAsync(files[0]);
+    CloseAsync(files[1]);
+    TEST_ASSERT(group->ag_Files == NULL, "CloseAsync should leave the group");
+    DeleteAsyncGroup(group);
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test TryReadAsync, TryWriteAsync and ReadSomeAsync */
+BOOL test_try_operations(void)
+{
+    struct AsyncFile *file;
+    UBYTE buffer[700];
+    LONG result;
+    LONG total;
+    int i;
+
+    TEST_START("TryWriteAsync/TryReadAsync/ReadSomeAsync - Take only what is there");
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for writing");
+
+    for (total = 0; total < 10000; total += result) {
+        for (i = 0; i < 700; i++) {
+            buffer[i] = (UBYTE)((total + i) % 89);
+        }
+        result = TryWriteAsync(file, buffer, 10000 - total < 700 ? 10000 - total : 700);
+        if (result < 0) {
+            TEST_ASSERT(FALSE, "TryWriteAsync should not fail");
+        }
+        if (result == 0) {
+            /* no room yet, so wait for it */
+            result = WriteAsync(file, buffer, 1);
+            if (result != 1) {
+                TEST_ASSERT(FALSE, "WriteAsync should succeed");
+            }
+        }
+    }
+    result = CloseAsync(file);
+    TEST_ASSERT(result >= 0, "CloseAsync should succeed");
+
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+
+    total = 0;
+    for (;;) {
+        result = TryReadAsync(file, buffer, 700);
+        if (result == ASYNC_NOTREADY) {
+            /* nothing there yet, so wait for at least a byte */
+            result = ReadSomeAsync(file, buffer, 700, total & 1 ? -1 : 1000000);
+        }
+        if (result == ASYNC_NOTREADY) {
+            continue;
+        }
+        if (result <= 0) {
+            break;
+        }
+        for (i = 0; i < result; i++) {
+            if (buffer[i] != (UBYTE)((total + i) % 89)) {
+                TRACE1("Data differs at %ld", total + i);
+                TEST_ASSERT(FALSE, "Data should read back unchanged");
+            }
+        }
+        total += result;
+    }
+    TEST_ASSERT(result == 0, "Reading should end with EOF, not an error");
+    TEST_ASSERT(total == 10000, "All data should be read");
+    TEST_ASSERT(TryReadAsync(file, buffer, 700) == 0, "TryReadAsync should return 0 at EOF");
+    TEST_ASSERT(ReadSomeAsync(file, buffer, 700, 1000) == 0, "ReadSomeAsync should return 0 at EOF");
+    CloseAsync(file);
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test OpenAsyncBatch, NextAsyncBatch and EndAsyncBatch */
+BOOL test_batch_operations(void)
+{
+    static char names[8][32];
+    STRPTR list[8];
+    struct AsyncBatch *batch;
+    struct AsyncFile *file;
+    LONG index;
+    LONG expected;
+    LONG c;
+    int i, j;
+
+    TEST_START("OpenAsyncBatch - Open a list of files ahead of their use");
+    for (i = 0; i < 8; i++) {
+        sprintf(names[i], "T:asyncio_batch%d.dat", i);
+        list[i] = (STRPTR)names[i];
+        DeleteFile(list[i]);
+        if (i == 5) {
+            continue; /* this one is missing */
+        }
+        file = OpenAsync(list[i], MODE_WRITE, 1024);
+        TEST_ASSERT(file != NULL, "OpenAsync should succeed for writing");
+        for (j = 0; j < 100 * i; j++) {
+            WriteCharAsync(file, (UBYTE)(i + j));
+        }
+        CloseAsync(file);
+    }
+
+    batch = OpenAsyncBatch(list, 8, MODE_READ, 1024);
+    TEST_ASSERT(batch != NULL, "OpenAsyncBatch should succeed");
+
+    expected = 0;
+    while ((index = NextAsyncBatch(batch, &file)) >= 0) {
+        if (index != expected++) {
+            TEST_ASSERT(FALSE, "NextAsyncBatch should return the files in order");
+        }
+        if (index == 5) {
+            TEST_ASSERT(file == NULL && IoErr() == ERROR_OBJECT_NOT_FOUND, "A missing file should fail");
+            continue;
+        }
+        if (file == NULL) {
+            TRACE1("File %ld failed to open", index);
+            TEST_ASSERT(FALSE, "NextAsyncBatch should open the file");
+        }
+        for (j = 0; j < 100 * index; j++) {
+            c = ReadCharAsync(file);
+            if (c != (UBYTE)(index + j)) {
+                TRACE2("File %ld differs at %ld", index, (LONG)j);
+                TEST_ASSERT(FALSE, "The file should hold its own data");
+            }
+        }
+        TEST_ASSERT(ReadCharAsync(file) == -1, "The file should end after its data");
+        CloseAsync(file);
+    }
+    TEST_ASSERT(expected == 8, "NextAsyncBatch should return every file");
+    EndAsyncBatch(batch);
+
+    /* ending a batch early closes the files opened ahead */
+    batch = OpenAsyncBatch(list, 8, MODE_READ, 1024);
+    TEST_ASSERT(batch != NULL, "OpenAsyncBatch should succeed");
+    index = NextAsyncBatch(batch, &file);
+    TEST_ASSERT(index == 0 && file != NULL, "NextAsyncBatch should return the first file");
+    CloseAsync(file);
+    EndAsyncBatch(batch);
+
+    for (i = 0; i < 8; i++) {
+        DeleteFile(list[i]);
+    }
+    TEST_PASS();
+    return TRUE;
+}
+
+BOOL test_geometry_cache(void)
+{
+    static struct InfoData infoData; /* longword aligned */
+    struct AsyncFile *file;
+    char buffer[16];
+    BPTR lock;
+    LONG blockSize;
+    int i;
+
+    TEST_START("Block size cache - Opens on a known volume skip Info()");
+    lock = Lock("T:", ACCESS_READ);
+    TEST_ASSERT(lock != NULL, "Lock should succeed");
+    TEST_ASSERT(Info(lock, &infoData), "Info should succeed");
+    UnLock(lock);
+    blockSize = infoData.id_BytesPerBlock;
+
+    /* the first open may ask the file system, the others use the cache */
+    for (i = 0; i < 3; i++) {
+        file = OpenAsync(TEST_FILE_NAME, MODE_WRITE, 1000);
+        TEST_ASSERT(file != NULL, "OpenAsync should succeed for writing");
+        TEST_ASSERT(file->af_BlockSize == blockSize, "The block size should be that of the volume");
+        TEST_ASSERT((file->af_BufferSize * 2) % (blockSize * 2) == 0, "The buffers should be rounded up to the blocks");
+        TEST_ASSERT(WriteAsync(file, "geometry", 8) == 8, "WriteAsync should succeed");
+        TEST_ASSERT(CloseAsync(file) >= 0, "CloseAsync should succeed");
+
+        file = OpenAsync(TEST_FILE_NAME, MODE_READ, 1000);
+        TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+        TEST_ASSERT(file->af_BlockSize == blockSize, "The block size should be that of the volume");
+        TEST_ASSERT(ReadAsync(file, buffer, 9) == 8, "The file should read back");
+        CloseAsync(file);
+    }
+
+    DeleteFile(TEST_FILE_NAME);
+    TEST_PASS();
+    return TRUE;
+}
+
+BOOL test_dir_operations(void)
+{
+    static char name[64];
+    struct AsyncDir *dir;
+    struct AsyncBatch *batch;
+    struct AsyncFile *file;
+    struct ExAllData *entry;
+    STRPTR fileName;
+    BPTR lock;
+    LONG seen = 0;
+    LONG files = 0;
+    LONG index;
+    LONG c;
+    int i, j;
+
+    TEST_START("OpenAsyncDir - Read a directory ahead, and open its files");
+    lock = CreateDir("T:asyncio_dir");
+    if (lock != NULL) {
+        UnLock(lock);
+    }
+    lock = CreateDir("T:asyncio_dir/subdir");
+    if (lock != NULL) {
+        UnLock(lock);
+    }
+
+    /* enough files for a few buffers full */
+    for (i = 0; i < 40; i++) {
+        sprintf(name, "T:asyncio_dir/file%02d.dat", i);
+        file = OpenAsync(name, MODE_WRITE, 1024);
+        TEST_ASSERT(file != NULL, "OpenAsync should succeed for writing");
+        for (j = 0; j < i; j++) {
+            WriteCharAsync(file, (UBYTE)(i + j));
+        }
+        CloseAsync(file);
+    }
+
+    TEST_ASSERT(OpenAsyncDir("T:asyncio_dir", 0, 1024) == NULL && IoErr() == ERROR_BAD_NUMBER, "A bad type should fail");
+    TEST_ASSERT(OpenAsyncDir("T:asyncio_nodir", ED_TYPE, 1024) == NULL, "A missing directory should fail");
+
+    dir = OpenAsyncDir("T:asyncio_dir", ED_SIZE, 1024);
+    TEST_ASSERT(dir != NULL, "OpenAsyncDir should succeed");
+    while ((entry = ReadAsyncDir(dir)) != NULL) {
+        if (!strcmp((char *)entry->ed_Name, "subdir")) {
+            TEST_ASSERT(entry->ed_Type > 0, "A directory should have a positive type");
+        } else {
+            TEST_ASSERT(entry->ed_Type < 0, "A file should have a negative type");
+            TEST_ASSERT(entry->ed_Size == atoi((char *)entry->ed_Name + 4), "The size should be that of the file");
+            files++;
+        }
+        seen++;
+    }
+    TEST_ASSERT(IoErr() == ERROR_NO_MORE_ENTRIES, "The end should be ERROR_NO_MORE_ENTRIES");
+    TEST_ASSERT(seen == 41 && files == 40, "Every entry should be read once");
+    TEST_ASSERT(ReadAsyncDir(dir) == NULL, "The end should stay the end");
+    CloseAsyncDir(dir);
+
+    /* stopping early */
+    dir = OpenAsyncDir("T:asyncio_dir", ED_NAME, 1024);
+    TEST_ASSERT(dir != NULL, "OpenAsyncDir should succeed");
+    TEST_ASSERT(ReadAsyncDir(dir) != NULL, "ReadAsyncDir should return an entry");
+    CloseAsyncDir(dir);
+    CloseAsyncDir(NULL);
+
+    /* the files are opened as the names come in */
+    dir = OpenAsyncDir("T:asyncio_dir", ED_TYPE, 1024);
+    TEST_ASSERT(dir != NULL, "OpenAsyncDir should succeed");
+    batch = OpenAsyncDirBatch(dir, MODE_READ, 1024);
+    TEST_ASSERT(batch != NULL, "OpenAsyncDirBatch should succeed");
+    TEST_ASSERT(NameAsyncBatch(batch) == NULL, "There should be no name before the first file");
+    files = 0;
+    while ((index = NextAsyncBatch(batch, &file)) >= 0) {
+        TEST_ASSERT(index == files++, "NextAsyncBatch should count the files");
+        TEST_ASSERT(file != NULL, "NextAsyncBatch should open the file");
+        fileName = NameAsyncBatch(batch);
+        TEST_ASSERT(fileName != NULL && !strncmp((char *)fileName, "file", 4), "Only files should be opened");
+        i = atoi((char *)fileName + 4);
+        for (j = 0; j < i; j++) {
+            c = ReadCharAsync(file);
+            if (c != (UBYTE)(i + j)) {
+                TRACE2("File %ld differs at %ld", (LONG)i, (LONG)j);
+                TEST_ASSERT(FALSE, "The file should hold its own data");
+            }
+        }
+        TEST_ASSERT(ReadCharAsync(file) == -1, "The file should end after its data");
+        CloseAsync(file);
+    }
+    TEST_ASSERT(IoErr() == ERROR_NO_MORE_ENTRIES, "The batch should end with the directory");
+    TEST_ASSERT(files == 40, "Every file should be opened");
+    EndAsyncBatch(batch);
+    CloseAsyncDir(dir);
+
+    for (i = 0; i < 40; i++) {
+        sprintf(name, "T:asyncio_dir/file%02d.dat", i);
+        DeleteFile(name);
+    }
+    DeleteFile("T:asyncio_dir/subdir");
+    DeleteFile("T:asyncio_dir");
+
+    /* entries of the same size, so some of these buffer sizes are filled
+     * exactly by the last of them
+     */
+    lock = CreateDir("T:asyncio_full");
+    if (lock != NULL) {
+        UnLock(lock);
+    }
+    for (i = 0; i < 48; i++) {
+        sprintf(name, "T:asyncio_full/entry%02d", i);
+        file = OpenAsync(name, MODE_WRITE, 1024);
+        TEST_ASSERT(file != NULL, "OpenAsync should succeed for writing");
+        CloseAsync(file);
+    }
+    for (c = 1024; c <= 2048; c += 8) {
+        dir = OpenAsyncDir("T:asyncio_full", ED_NAME, c);
+        TEST_ASSERT(dir != NULL, "OpenAsyncDir should succeed");
+        seen = 0;
+        while (ReadAsyncDir(dir) != NULL) {
+            seen++;
+        }
+        if (seen != 48) {
+            TRACE2("Buffer size %ld read %ld entries", c, seen);
+            TEST_ASSERT(FALSE, "Every entry should be read, however full the buffers are");
+        }
+        TEST_ASSERT(IoErr() == ERROR_NO_MORE_ENTRIES, "The end should be ERROR_NO_MORE_ENTRIES");
+        CloseAsyncDir(dir);
+    }
+    for (i = 0; i < 48; i++) {
+        sprintf(name, "T:asyncio_full/entry%02d", i);
+        DeleteFile(name);
+    }
+    DeleteFile("T:asyncio_full");
+    TEST_PASS();
+    return TRUE;
+}
+
+/* Test CreateAsyncScheduler, ScheduleAsync and DeleteAsyncScheduler */
+BOOL test_scheduler_operations(void)
+{
+    struct AsyncScheduler *scheduler;
+    struct AsyncGroup *group;
+    struct AsyncFile *files[2];
+    struct AsyncFile *file;
+    UBYTE buffer[1024];
+    LONG offsets[2];
+    LONG result;
+    int i, j;
+
+    TEST_START("ScheduleAsync - Files on one device take turns");
+    for (i = 0; i < 2; i++) {
+        file = OpenAsync((STRPTR)(i ? TEST_FILE_NAME2 : TEST_FILE_NAME), MODE_WRITE, 1024);
+        TEST_ASSERT(file != NULL, "OpenAsync should succeed for writing");
+        for (j = 0; j < 8000; j++) {
+            WriteCharAsync(file, (UBYTE)((j + i) % 97));
+        }
+        CloseAsync(file);
+    }
+
+    scheduler = CreateAsyncScheduler(4);
+    TEST_ASSERT(scheduler != NULL, "CreateAsyncScheduler should succeed");
+    for (i = 0; i < 2; i++) {
+        files[i] = OpenAsync((STRPTR)(i ? TEST_FILE_NAME2 : TEST_FILE_NAME), MODE_READ, 1024);
+        TEST_ASSERT(files[i] != NULL, "OpenAsync should succeed for reading");
+        TEST_ASSERT(ScheduleAsync(files[i], scheduler), "ScheduleAsync should succeed");
+        offsets[i] = 0;
+    }
+
+    /* the first file takes the device, and keeps it for its turn */
+    TEST_ASSERT(ReadAsync(files[0], buffer, 1) == 1, "ReadAsync should succeed");
+    TEST_ASSERT(ReadAsync(files[1], buffer, 1) == 1, "ReadAsync should succeed");
+    TEST_ASSERT(files[1]->af_Ticket != 0, "The read-ahead of the other file should be held");
+    TEST_ASSERT(ReadAsync(files[0], buffer, 600) == 600, "ReadAsync should succeed");
+    TEST_ASSERT(files[1]->af_Ticket != 0, "The read-ahead should still be held during the turn");
+    offsets[0] = 601;
+
+    /* waiting with a timeout gets the held read-ahead out once the device
+     * is free, rather than when the time is up
+     */
+    j = files[1]->af_BytesLeft;
+    TEST_ASSERT(ReadAsync(files[1], buffer, j) == j, "ReadAsync should succeed");
+    result = ReadSomeAsync(files[1], buffer, 700, 10000000);
+    TEST_ASSERT(result > 0, "ReadSomeAsync should get the held read-ahead");
+    TEST_ASSERT(buffer[0] == (UBYTE)((j + 2) % 97), "The data should be that of the file");
+    offsets[1] = 1 + j + result;
+
+    /* reading them in turns gets every packet out in the end */
+    while (offsets[0] < 8000 || offsets[1] < 8000) {
+        for (i = 0; i < 2; i++) {
+            result = ReadAsync(files[i], buffer, 700);
+            if (offsets[i] < 8000) {
+                TEST_ASSERT(result > 0, "ReadAsync should return data");
+            }
+            for (j = 0; j < result; j++) {
+                if (buffer[j] != (UBYTE)((offsets[i] + j + i) % 97)) {
+                    TRACE2("File %ld differs at %ld", (LONG)i, offsets[i] + j);
+                    TEST_ASSERT(FALSE, "The data should be that of the file");
+                }
+            }
+            offsets[i] += result;
+        }
+    }
+    TEST_ASSERT(ReadAsync(files[0], buffer, 1) == 0, "The file should end after its data");
+    TEST_ASSERT(SeekAsync(files[1], 100, MODE_START) >= 0, "SeekAsync should succeed");
+    TEST_ASSERT(ReadAsync(files[1], buffer, 1) == 1 && buffer[0] == 101 % 97, "Seeking should work while scheduled");
+
+    /* a file in a group leaves its scheduler, and the other way round */
+    group = CreateAsyncGroup();
+    TEST_ASSERT(group != NULL, "CreateAsyncGroup should succeed");
+    AttachAsync(files[1], group);
+    TEST_ASSERT(files[1]->af_Scheduler == NULL, "AttachAsync should take the file out of its scheduler");
+    TEST_ASSERT(ScheduleAsync(files[1], scheduler), "ScheduleAsync should succeed");
+    TEST_ASSERT(files[1]->af_Group == NULL, "ScheduleAsync should take the file out of its group");
+    DeleteAsyncGroup(group);
+
+    TEST_ASSERT(CloseAsync(files[0]) >= 0, "CloseAsync should succeed while scheduled");
+    DeleteAsyncScheduler(scheduler);
+    TEST_ASSERT(files[1]->af_Scheduler == NULL, "DeleteAsyncScheduler should let go of the files");
+    TEST_ASSERT(ReadAsync(files[1], buffer, 1) == 1, "The file should still be usable");
+    CloseAsync(files[1]);
+    DeleteAsyncScheduler(NULL);
+
+    DeleteFile(TEST_FILE_NAME);
+    DeleteFile(TEST_FILE_NAME2);
+    TEST_PASS();
+    return TRUE;
+}
+
+BOOL test_priority_operations(void)
+{
+    struct AsyncScheduler *scheduler;
+    struct AsyncFile *files[2];
+    struct AsyncFile *file;
+    struct DateStamp start, end;
+    UBYTE buffer[1024];
+    LONG offsets[2];
+    LONG result, total, ticks;
+    int i, j;
+
+    TEST_START("SetPriorityAsync - Priorities and rate limits");
+    for (i = 0; i < 2; i++) {
+        file = OpenAsync((STRPTR)(i ? TEST_FILE_NAME2 : TEST_FILE_NAME), MODE_WRITE, 1024);
+        TEST_ASSERT(file != NULL, "OpenAsync should succeed for writing");
+        for (j = 0; j < 20000; j++) {
+            WriteCharAsync(file, (UBYTE)((j + i) % 89));
+        }
+        CloseAsync(file);
+    }
+
+    /* 20000 bytes at 10000 bytes per second take about two seconds */
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_READ, 2048);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for reading");
+    TEST_ASSERT(file->af_Priority == ASYNCPRI_NORMAL && file->af_MaxRate == 0, "A new file should have no priority or limit");
+    SetPriorityAsync(file, ASYNCPRI_BACKGROUND, 10000);
+    TEST_ASSERT(file->af_MaxRate == 10000, "SetPriorityAsync should set the rate");
+    DateStamp(&start);
+    total = 0;
+    while ((result = ReadAsync(file, buffer, sizeof(buffer))) > 0) {
+        total += result;
+    }
+    DateStamp(&end);
+    ticks = (end.ds_Days - start.ds_Days) * 24 * 60 * 60 * TICKS_PER_SECOND +
+            (end.ds_Minute - start.ds_Minute) * 60 * TICKS_PER_SECOND +
+            (end.ds_Tick - start.ds_Tick);
+    TRACE1("Reading at a limited rate took %ld ticks", ticks);
+    TEST_ASSERT(total == 20000, "All the data should be read at a limited rate");
+    TEST_ASSERT(ticks >= 4 * TICKS_PER_SECOND / 5, "The rate limit should slow the reading down");
+    SetPriorityAsync(file, ASYNCPRI_NORMAL, 0);
+    TEST_ASSERT(file->af_MaxRate == 0, "A rate of 0 should remove the limit");
+    TEST_ASSERT(SeekAsync(file, 0, MODE_START) >= 0, "SeekAsync should succeed");
+    TEST_ASSERT(ReadAsync(file, buffer, 10) == 10, "ReadAsync should succeed without a limit");
+    CloseAsync(file);
+
+    /* the foreground file goes before the background one */
+    scheduler = CreateAsyncScheduler(4);
+    TEST_ASSERT(scheduler != NULL, "CreateAsyncScheduler should succeed");
+    for (i = 0; i < 2; i++) {
+        files[i] = OpenAsync((STRPTR)(i ? TEST_FILE_NAME2 : TEST_FILE_NAME), MODE_READ, 1024);
+        TEST_ASSERT(files[i] != NULL, "OpenAsync should succeed for reading");
+        TEST_ASSERT(ScheduleAsync(files[i], scheduler), "ScheduleAsync should succeed");
+    }
+    SetPriorityAsync(files[0], ASYNCPRI_BACKGROUND, 0);
+    SetPriorityAsync(files[1], ASYNCPRI_FOREGROUND, 0);
+
+    TEST_ASSERT(ReadAsync(files[0], buffer, 1) == 1, "ReadAsync should succeed");
+    TEST_ASSERT(ReadAsync(files[1], buffer, 1) == 1, "ReadAsync should succeed");
+    TEST_ASSERT(files[1]->af_Ticket == 0, "The foreground file should not wait for the turn of the other");
+    TEST_ASSERT(ReadAsync(files[0], buffer, 600) == 600, "ReadAsync should succeed");
+    TEST_ASSERT(files[0]->af_Ticket != 0, "The background read-ahead should be held");
+    offsets[0] = 601;
+    offsets[1] = 1;
+
+    /* the background file still gets all of its data */
+    while (offsets[0] < 20000 || offsets[1] < 20000) {
+        for (i = 0; i < 2; i++) {
+            result = ReadAsync(files[i], buffer, 900);
+            if (offsets[i] < 20000) {
+                TEST_ASSERT(result > 0, "ReadAsync should return data");
+            }
+            for (j = 0; j < result; j++) {
+                if (buffer[j] != (UBYTE)((offsets[i] + j + i) % 89)) {
+                    TRACE2("File %ld differs at %ld", (LONG)i, offsets[i] + j);
+                    TEST_ASSERT(FALSE, "The data should be that of the file");
+                }
+            }
+            offsets[i] += result;
+        }
+    }
+
+    CloseAsync(files[0]);
+    CloseAsync(files[1]);
+    DeleteAsyncScheduler(scheduler);
+
+    DeleteFile(TEST_FILE_NAME);
+    DeleteFile(TEST_FILE_NAME2);
+    TEST_PASS();
+    return TRUE;
+}
+
+BOOL test_scan_operations(void)
+{
+    struct AsyncScan *scan;
+    struct AsyncFile *file;
+    UBYTE *data, *ranges[4];
+    UBYTE buffer[700];
+    LONG lengths[4];
+    LONG size = 0;
+    LONG result, index, last, switches, offset;
+    int i, j;
+
+    TEST_START("OpenAsyncScan - Ranges of a file read side by side");
+    data = AllocVec(5 * 40000, MEMF_ANY);
+    TEST_ASSERT(data != NULL, "AllocVec should succeed");
+    for (i = 0; i < 4; i++) {
+        ranges[i] = data + (i + 1) * 40000;
+    }
+
+    /* lines of different lengths, so the even split falls inside them */
+    file = OpenAsync((STRPTR)TEST_FILE_NAME, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for writing");
+    for (i = 0; i < 2000; i++) {
+        for (j = 0; j <= i % 23; j++) {
+            data[size++] = (UBYTE)('a' + (i + j) % 26);
+        }
+        data[size++] = '\n';
+    }
+    TEST_ASSERT(WriteAsync(file, data, size) == size, "WriteAsync should succeed");
+    CloseAsync(file);
+
+    scan = OpenAsyncScan((STRPTR)TEST_FILE_NAME, 4, '\n', 1024);
+    TEST_ASSERT(scan != NULL, "OpenAsyncScan should succeed");
+    for (i = 0; i < 4; i++) {
+        lengths[i] = 0;
+    }
+    last = -1;
+    switches = 0;
+    while ((result = ReadAsyncScan(scan, buffer, sizeof(buffer), &index)) > 0) {
+        TEST_ASSERT(index >= 0 && index < 4, "ReadAsyncScan should name the range");
+        TEST_ASSERT(lengths[index] + result <= 40000, "A range should not be larger than the file");
+        memcpy(ranges[index] + lengths[index], buffer, result);
+        lengths[index] += result;
+        if (index != last) {
+            switches++;
+            last = index;
+        }
+    }
+    TEST_ASSERT(result == 0 && index == -1, "ReadAsyncScan should return 0 after the last range");
+    TRACE1("The ranges took turns %ld times", switches);
+    TEST_ASSERT(switches > 4, "The ranges should be read side by side");
+
+    /* the ranges end on lines, and make up the file in order */
+    offset = 0;
+    for (i = 0; i < 4; i++) {
+        TRACE2("Range %ld has %ld bytes", (LONG)i, lengths[i]);
+        TEST_ASSERT(lengths[i] > 0, "Each range should have data");
+        TEST_ASSERT(ranges[i][lengths[i] - 1] == '\n', "Each range should end on a line");
+        TEST_ASSERT(memcmp(ranges[i], data + offset, lengths[i]) == 0, "The ranges should be the file in order");
+        offset += lengths[i];
+    }
+    TEST_ASSERT(offset == size, "The ranges should cover the whole file");
+    CloseAsyncScan(scan);
+
+    /* without a separator, the ranges are split evenly */
+    scan = OpenAsyncScan((STRPTR)TEST_FILE_NAME, 3, -1, 1024);
+    TEST_ASSERT(scan != NULL, "OpenAsyncScan should succeed without a separator");
+    for (i = 0; i < 3; i++) {
+        lengths[i] = 0;
+    }
+    while ((result = ReadAsyncScan(scan, buffer, sizeof(buffer), &index)) > 0) {
+        lengths[index] += result;
+    }
+    TEST_ASSERT(lengths[0] == size / 3 && lengths[0] + lengths[1] + lengths[2] == size, "The ranges should be split evenly");
+    CloseAsyncScan(scan);
+
+    /* more ranges than lines leaves some of them empty */
+    file = OpenAsync((STRPTR)TEST_FILE_NAME2, MODE_WRITE, 1024);
+    TEST_ASSERT(file != NULL, "OpenAsync should succeed for writing");
+    TEST_ASSERT(WriteAsync(file, "one\ntwo\n", 8) == 8, "WriteAsync should succeed");
+    CloseAsync(file);
+    scan = OpenAsyncScan((STRPTR)TEST_FILE_NAME2, 6, '\n', 1024);
+    TEST_ASSERT(scan != NULL, "OpenAsyncScan should succeed for a small file");
+    offset = 0;
+    while ((result = ReadAsyncScan(scan, buffer + offset, sizeof(buffer) - offset, &index)) > 0) {
+        offset += result;
+    }
+    TEST_ASSERT(offset == 8, "All the lines of a small file should be read once");
+    CloseAsyncScan(scan);
+    CloseAsyncScan(NULL);
+
+    scan = OpenAsyncScan((STRPTR)"T:asyncio_no_such_file.dat", 2, '\n', 1024);
+    TEST_ASSERT(scan == NULL, "OpenAsyncScan should fail for a missing file");
+
+    FreeVec(data);
+    DeleteFile(TEST_FILE_NAME);
+    DeleteFile(TEST_FILE_NAME2);
+    TEST_PASS();
+    return TRUE;
+}
+
 /* Cleanup test files */
 void cleanup_test_files(void)
 {
@@ -1910,7 +4047,7 @@ void print_test_summary(void)
     printf("Total tests: %ld\n", test_count);
     printf("Passed: %ld\n", test_passed);
     printf("Failed: %ld\n", test_failed);
-    printf("Success rate: %f%%\n", (test_count > 0) ? (test_passed * 100.0 / test_count) : 0.0)
+    printf("Success rate: %f%%\n", (test_count > 0) ? (test_passed * 100.0 / test_count) : 0.0);
     
     if (test_failed == 0) {
         printf("\nALL TESTS PASSED! \\o/\n");